@@ -15,6 +15,210 @@
 
 namespace VSTGUI {
 
+/**
+\brief set the audio-thread pre-decimation; call before the view is registered with the plugin
+
+\param _decimation the decimation type
+\param _samplesPerPoint number of input samples reduced to one output point (ignored for kNoDecimation)
+*/
+void CustomViewBlockQueue::setDecimation(customViewDecimation _decimation, uint32_t _samplesPerPoint)
+{
+	decimation = _decimation;
+	samplesPerPoint = _samplesPerPoint > 0 ? _samplesPerPoint : 1;
+	pointCounter = 0;
+}
+
+/**
+\brief audio thread: decimate (optionally) and copy values into the current block
+
+\param values the incoming values
+\param numValues number of values
+*/
+void CustomViewBlockQueue::pushBlock(const float* values, uint32_t numValues)
+{
+	if (decimation == customViewDecimation::kNoDecimation)
+	{
+		for (uint32_t i = 0; i < numValues; i++)
+			writeValue(values[i]);
+		return;
+	}
+
+	for (uint32_t i = 0; i < numValues; i++)
+	{
+		float value = values[i];
+		if (pointCounter == 0)
+		{
+			pointMin = value;
+			pointMax = value;
+			pointSumSquares = 0.0;
+		}
+		else
+		{
+			if (value < pointMin) pointMin = value;
+			if (value > pointMax) pointMax = value;
+		}
+		pointSumSquares += (double)value*(double)value;
+
+		if (++pointCounter < samplesPerPoint)
+			continue;
+
+		// --- one point done; DATA_BLOCK_LEN is even so (min, max) pairs never straddle blocks
+		if (decimation == customViewDecimation::kMinMaxDecimation)
+		{
+			writeValue(pointMin);
+			writeValue(pointMax);
+		}
+		else
+			writeValue((float)sqrt(pointSumSquares / (double)samplesPerPoint));
+
+		pointCounter = 0;
+	}
+}
+
+/**
+\brief audio thread: append one value to the current block, grabbing a free block if needed
+
+\param value the value to write
+*/
+void CustomViewBlockQueue::writeValue(float value)
+{
+	if (!currentBlock)
+	{
+		uint32_t write = writeIndex.load(std::memory_order_relaxed);
+		uint32_t read = readIndex.load(std::memory_order_acquire);
+
+		// --- ring is full; GUI is not reading (closed or stalled)
+		if (write - read >= DATA_BLOCK_QUEUE_LEN)
+		{
+			droppedValues.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		currentBlock = &blocks[write & (DATA_BLOCK_QUEUE_LEN - 1)];
+		currentBlock->numValues = 0;
+	}
+
+	currentBlock->data[currentBlock->numValues++] = value;
+
+	// --- publish
+	if (currentBlock->numValues == DATA_BLOCK_LEN)
+	{
+		writeIndex.store(writeIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		currentBlock = nullptr;
+	}
+}
+
+/**
+\brief GUI thread: get the oldest published block
+
+\return the block, or nullptr if no block is waiting
+*/
+const CustomViewDataBlock* CustomViewBlockQueue::frontBlock()
+{
+	uint32_t read = readIndex.load(std::memory_order_relaxed);
+	if (read == writeIndex.load(std::memory_order_acquire))
+		return nullptr;
+
+	return &blocks[read & (DATA_BLOCK_QUEUE_LEN - 1)];
+}
+
+/**
+\brief GUI thread: hand the block from frontBlock( ) back to the producer
+*/
+void CustomViewBlockQueue::popBlock()
+{
+	readIndex.store(readIndex.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+\brief allocate each level and clear
+
+\param _length number of points each level keeps (usually the view width in pixels)
+*/
+void WaveformPyramid::init(uint32_t _length)
+{
+	length = _length > 0 ? _length : 1;
+	for (uint32_t i = 0; i < WAVEFORM_PYRAMID_LEVELS; i++)
+	{
+		levels[i].minBuffer.assign(length, 0.f);
+		levels[i].maxBuffer.assign(length, 0.f);
+	}
+	clear();
+}
+
+/**
+\brief clear all levels (keeps the allocation)
+*/
+void WaveformPyramid::clear()
+{
+	for (uint32_t i = 0; i < WAVEFORM_PYRAMID_LEVELS; i++)
+	{
+		std::fill(levels[i].minBuffer.begin(), levels[i].minBuffer.end(), 0.f);
+		std::fill(levels[i].maxBuffer.begin(), levels[i].maxBuffer.end(), 0.f);
+		levels[i].count = 0;
+		levels[i].hasPending = false;
+	}
+}
+
+/**
+\brief add a level-0 point; every second point at a level is merged with its partner and carried up
+
+\param pointMin the minimum over the point's samples
+\param pointMax the maximum over the point's samples
+*/
+void WaveformPyramid::addPoint(float pointMin, float pointMax)
+{
+	if (length == 0) return;
+
+	for (uint32_t level = 0; level < WAVEFORM_PYRAMID_LEVELS; level++)
+	{
+		PyramidLevel& thisLevel = levels[level];
+		uint32_t writeIndex = (uint32_t)(thisLevel.count % length);
+		thisLevel.minBuffer[writeIndex] = pointMin;
+		thisLevel.maxBuffer[writeIndex] = pointMax;
+		thisLevel.count++;
+
+		// --- wait for the partner point
+		if (!thisLevel.hasPending)
+		{
+			thisLevel.pendingMin = pointMin;
+			thisLevel.pendingMax = pointMax;
+			thisLevel.hasPending = true;
+			return;
+		}
+
+		// --- merge the pair and carry it to the next level
+		pointMin = thisLevel.pendingMin < pointMin ? thisLevel.pendingMin : pointMin;
+		pointMax = thisLevel.pendingMax > pointMax ? thisLevel.pendingMax : pointMax;
+		thisLevel.hasPending = false;
+	}
+}
+
+/**
+\brief get a point by absolute index
+
+\param level the pyramid level
+\param index the absolute index (0 = first point ever written at that level)
+\param pointMin return value for the min
+\param pointMax return value for the max
+
+\return true if the point is still in the history
+*/
+bool WaveformPyramid::getPoint(uint32_t level, uint64_t index, float& pointMin, float& pointMax)
+{
+	if (level >= WAVEFORM_PYRAMID_LEVELS || length == 0)
+		return false;
+
+	PyramidLevel& thisLevel = levels[level];
+	if (index >= thisLevel.count || thisLevel.count - index > length)
+		return false;
+
+	uint32_t readIndex = (uint32_t)(index % length);
+	pointMin = thisLevel.minBuffer[readIndex];
+	pointMax = thisLevel.maxBuffer[readIndex];
+	return true;
+}
+
 /**
 \brief WaveView constructor
 
@@ -26,29 +230,30 @@ WaveView::WaveView(const VSTGUI::CRect& size, IControlListener* listener, int32_
 : CControl(size, listener, tag)
 , ICustomView()
 {
-    // --- create circular buffer that is same size as the window is wide
-	circularBuffer = new double[(int)size.getWidth()];
+    // --- one history point per pixel column at every zoom level
+	circularBufferLength = (int)size.getWidth() > 0 ? (int)size.getWidth() : 1;
+	pyramid.init(circularBufferLength);
 
     // --- init
-	writeIndex = 0;
-	readIndex = 0;
-	circularBufferLength = (int)size.getWidth();
-    memset(circularBuffer, 0, circularBufferLength*sizeof(double));
 	paintXAxis = true;
 	currentRect = size;
 
     // --- ICustomView
     // --- create our incoming data-queue
     dataQueue = new moodycamel::ReaderWriterQueue<double, DATA_QUEUE_LEN>;
+
+    // --- block queue; the audio thread reduces to one (min, max) level-0 point per WAVEVIEW_SAMPLES_PER_POINT samples
+    blockQueue = new CustomViewBlockQueue;
+    blockQueue->setDecimation(customViewDecimation::kMinMaxDecimation, WAVEVIEW_SAMPLES_PER_POINT);
 }
 
 WaveView::~WaveView()
 {
-    if(circularBuffer)
-        delete [] circularBuffer;
-
     if(dataQueue)
         delete dataQueue;
+
+    if(blockQueue)
+        delete blockQueue;
 }
 
 void WaveView::pushDataValue(double data)
@@ -59,276 +264,579 @@ void WaveView::pushDataValue(double data)
     dataQueue->enqueue(data);
 }
 
+void WaveView::pushDataBlock(const float* data, uint32_t numValues)
+{
+    if(!blockQueue) return;
+
+    // --- one copy (with min/max reduction) per buffer; no per-sample enqueue
+    blockQueue->pushBlock(data, numValues);
+}
+
 void WaveView::updateView()
 {
-    // --- get the max value that was added to the queue during the last
-    //     GUI timer ping interval
+    // --- per-value data: reduce to (min, max) points here on the GUI thread
     double audioSample = 0.0;
-    double max = 0.0;
-    bool success = dataQueue->try_dequeue(audioSample);
-    if(success)
+    while(dataQueue->try_dequeue(audioSample))
     {
-        max = audioSample;
-        while(success)
+        float value = (float)audioSample;
+        if(valueCounter == 0)
+        {
+            valueMin = value;
+            valueMax = value;
+        }
+        else
         {
-            success = dataQueue->try_dequeue(audioSample);
-            if(success && audioSample > max)
-                max = audioSample;
+            if(value < valueMin) valueMin = value;
+            if(value > valueMax) valueMax = value;
         }
 
-        // --- add to circular buffer
-        addWaveDataPoint(fabs(max));
+        if(++valueCounter == WAVEVIEW_SAMPLES_PER_POINT)
+        {
+            pyramid.addPoint(valueMin, valueMax);
+            valueCounter = 0;
+        }
     }
 
+    // --- blocks already hold (min, max) pairs
+    const CustomViewDataBlock* block = blockQueue->frontBlock();
+    while(block)
+    {
+        for(uint32_t i = 0; i + 1 < block->numValues; i += 2)
+            pyramid.addPoint(block->data[i], block->data[i + 1]);
+
+        blockQueue->popBlock();
+        block = blockQueue->frontBlock();
+    }
+
+    // --- nothing new at this zoom level: nothing to repaint
+    if(!repaintAll && pyramid.getPointCount(zoomLevel) == renderedCount)
+        return;
+
+    // --- stroke only the new columns into the offscreen plot
+    renderNewColumns();
+
     // --- this will set the dirty flag to repaint the view
     invalid();
 }
 
 void WaveView::addWaveDataPoint(float fSample)
 {
-	if(!circularBuffer) return;
-	circularBuffer[writeIndex] = fSample;
-	writeIndex++;
-	if(writeIndex > circularBufferLength - 1)
-		writeIndex = 0;
+	float magnitude = fabs(fSample);
+	pyramid.addPoint(-magnitude, magnitude);
 }
 
 void WaveView::clearBuffer()
 {
-	if(!circularBuffer) return;
-	memset(circularBuffer, 0, circularBufferLength*sizeof(float));
-	writeIndex = 0;
-	readIndex = 0;
+	pyramid.clear();
+	valueCounter = 0;
+	renderedCount = 0;
+	repaintAll = true;
 }
 
-void WaveView::draw(CDrawContext* pContext)
+void WaveView::setZoomLevel(uint32_t level)
 {
-    // --- setup the backround rectangle
-    int frameWidth = 1;
-    int plotLineWidth = 1;
-    pContext->setLineWidth(frameWidth);
-    pContext->setFillColor(CColor(200, 200, 200, 255)); // light grey
-    pContext->setFrameColor(CColor(0, 0, 0, 255)); // black
-	CRect size = getViewSize();
+	if(level >= WAVEFORM_PYRAMID_LEVELS)
+		level = WAVEFORM_PYRAMID_LEVELS - 1;
 
-    // --- draw the rect filled (with grey) and stroked (line around rectangle)
-    pContext->drawRect(size, kDrawFilledAndStroked);
+	if(level == zoomLevel)
+		return;
 
-    // --- this will be the line color when drawing lines
-    //     alpha value is 200, so color is semi-transparent
-    pContext->setFrameColor(CColor(32, 0, 255, 200));
-    pContext->setLineWidth(plotLineWidth);
-
-    if(!circularBuffer) return;
-
-    // --- step through buffer
-    int index = writeIndex - 1;
-    if(index < 0)
-        index = circularBufferLength - 1;
-
-    for(int i=1; i<circularBufferLength; i++)
-    {
-        double sample = circularBuffer[index--];
-
-        double normalized = sample*(double)size.getHeight();
-        if(normalized > size.getHeight() - 2)
-            normalized = (double)size.getHeight();
-
-        // --- so there is an x-axis even if no data
-        if(normalized == 0) normalized = 0.1f;
-
-        if (paintXAxis)
-        {
-            const CPoint p1(size.left + i, size.bottom - size.getHeight() / 2.f);
-            const CPoint p2(size.left + i, size.bottom - size.getHeight() / 2.f - 1.0);
-            const CPoint p3(size.left + i, size.bottom - size.getHeight() / 2.f + 1.0);
+	zoomLevel = level;
+	renderedCount = 0;
+	repaintAll = true;
+	invalid();
+}
 
-            // --- move and draw lines
-            pContext->drawLine(p1, p2);
+void WaveView::drawColumn(CDrawContext* pContext, CCoord x, uint64_t index)
+{
+	CCoord height = currentRect.getHeight();
+	CCoord center = height / 2.0;
+
+	// --- clear the column to the background
+	pContext->setFillColor(CColor(200, 200, 200, 255)); // light grey
+	pContext->drawRect(CRect(x, 0, x + 1, height), kDrawFilled);
+
+	// --- so there is an x-axis even if no data
+	if (paintXAxis)
+	{
+		pContext->setFrameColor(CColor(32, 0, 255, 200));
+		const CPoint p1(x, center);
+		const CPoint p2(x, center - 1.0);
+		const CPoint p3(x, center + 1.0);
+		pContext->drawLine(p1, p2);
 #ifndef MAC
-            pContext->drawLine(p1, p3); // MacOS render is a bit different, this just makes them look consistent
+		pContext->drawLine(p1, p3); // MacOS render is a bit different, this just makes them look consistent
 #endif
-        }
-
-        // --- halves
-        normalized /= 2.f;
+	}
+
+	float pointMin = 0.f;
+	float pointMax = 0.f;
+	if (!pyramid.getPoint(zoomLevel, index, pointMin, pointMax))
+		return;
+
+	// --- min/max to pixels; +/-1.0 fills the view, leave room for the frame
+	CCoord yTop = center - pointMax*center;
+	CCoord yBottom = center - pointMin*center;
+	if (yTop < 1.0) yTop = 1.0;
+	if (yBottom > height - 1.0) yBottom = height - 1.0;
+	if (yBottom < yTop) yBottom = yTop;
+
+	pContext->setFrameColor(CColor(32, 0, 255, 200));
+	pContext->drawLine(CPoint(x, yTop), CPoint(x, yBottom));
+}
 
-        // --- find the three points of interest
-        const CPoint p1(size.left + i, size.bottom - size.getHeight()/2.f);
-        const CPoint p2(size.left + i, size.bottom - size.getHeight()/2.f - normalized);
-        const CPoint p3(size.left + i, size.bottom - size.getHeight()/2.f + normalized);
+void WaveView::renderNewColumns()
+{
+	// --- create the offscreen plot once we are attached to a frame
+	if (!plotContext)
+	{
+		if (!getFrame())
+			return;
+
+		plotContext = COffscreenContext::create(getFrame(), circularBufferLength, currentRect.getHeight(), getFrame()->getScaleFactor());
+		if (!plotContext)
+			return;
+
+		repaintAll = true;
+	}
+
+	int64_t width = circularBufferLength;
+	int64_t count = (int64_t)pyramid.getPointCount(zoomLevel);
+	int64_t first = (int64_t)renderedCount;
+
+	// --- too much is new (or zoom/clear): redo every column; columns with no data just get the background
+	if (repaintAll || count - first > width)
+		first = count - width;
+
+	plotContext->beginDraw();
+	plotContext->setLineWidth(1);
+	for (int64_t index = first; index < count; index++)
+	{
+		// --- newest point at the left edge: ring position decreases as the index increases
+		int64_t ringPosition = (width - 1) - (((index % width) + width) % width);
+		drawColumn(plotContext, (CCoord)ringPosition, index < 0 ? (uint64_t)-1 : (uint64_t)index);
+	}
+	plotContext->endDraw();
+
+	renderedCount = (uint64_t)count;
+	repaintAll = false;
+}
 
-        // --- move and draw lines
-        pContext->drawLine(p1, p2);
-        pContext->drawLine(p1, p3);
+void WaveView::draw(CDrawContext* pContext)
+{
+	CRect size = getViewSize();
+	currentRect = size;
 
-        // --- wrap the index value if needed
-        if(index < 0)
-            index = circularBufferLength - 1;
-    }
+	// --- first paint (or repaint after zoom): bring the offscreen plot up to date
+	if (repaintAll)
+		renderNewColumns();
+
+	int64_t width = circularBufferLength;
+	if (plotContext && plotContext->getBitmap())
+	{
+		// --- ring position of the newest column goes to the left edge; blit the ring in two pieces
+		int64_t newest = renderedCount > 0 ? (int64_t)((renderedCount - 1) % (uint64_t)width) : 0;
+		CCoord split = (CCoord)((width - 1) - newest);
+		CCoord leftWidth = (CCoord)width - split;
+
+		plotContext->getBitmap()->draw(pContext, CRect(size.left, size.top, size.left + leftWidth, size.bottom), CPoint(split, 0));
+		if (split > 0)
+			plotContext->getBitmap()->draw(pContext, CRect(size.left + leftWidth, size.top, size.right, size.bottom), CPoint(0, 0));
+	}
+	else
+	{
+		// --- no offscreen (not attached yet): stroke every column directly
+		pContext->setLineWidth(1);
+		CDrawContext::Transform transform(*pContext, CGraphicsTransform().translate(size.left, size.top));
+		uint64_t count = pyramid.getPointCount(zoomLevel);
+		for (int64_t x = 0; x < width; x++)
+			drawColumn(pContext, (CCoord)x, (int64_t)count - 1 - x < 0 ? (uint64_t)-1 : count - 1 - x);
+	}
+
+    // --- frame around the plot
+    pContext->setLineWidth(1);
+    pContext->setFrameColor(CColor(0, 0, 0, 255)); // black
+    pContext->drawRect(size, kDrawStroked);
 }
 
 #ifdef HAVE_FFTW
 /**
-\brief SpectrumView constructor
+\brief SpectrumAnalyzer constructor; configure( ) must be called before use
+*/
+SpectrumAnalyzer::SpectrumAnalyzer()
+{
+}
 
-\param size - the control rectangle
-\param listener - the control's listener (usuall PluginGUI object)
-\param tag - the control ID value
+/**
+\brief SpectrumAnalyzer destructor; stops the worker and frees FFTW memory
 */
-SpectrumView::SpectrumView(const VSTGUI::CRect& size, IControlListener* listener, int32_t tag)
-: CControl(size, listener, tag)
+SpectrumAnalyzer::~SpectrumAnalyzer()
 {
-    // --- ICustomView
-    // --- create our incoming data-queue
-    dataQueue = new moodycamel::ReaderWriterQueue<double,FFT_LEN>;
+	stop();
+	destroyFFT();
+}
 
-    // --- double buffers for mag FFTs
-    fftMagBuffersReady = new moodycamel::ReaderWriterQueue<double*,2>;
-    fftMagBuffersEmpty = new moodycamel::ReaderWriterQueue<double*,2>;
+/**
+\brief free the FFTW plan and buffers (worker must be stopped)
+*/
+void SpectrumAnalyzer::destroyFFT()
+{
+	if (plan)
+		fftw_destroy_plan(plan);
+	plan = nullptr;
 
-    // --- load up the empty queue with buffers
-    fftMagBuffersEmpty->enqueue(fftMagnitudeArray_A);
-    fftMagBuffersEmpty->enqueue(fftMagnitudeArray_B);
+	if (fftInput)
+		fftw_free(fftInput);
+	fftInput = nullptr;
 
-    // --- buffer being drawn, only ever used by draw code
-    currentFFTMagBuffer = nullptr;
+	if (fftOutput)
+		fftw_free(fftOutput);
+	fftOutput = nullptr;
+}
 
-    // --- FFTW inits
-    data        = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_LEN);
-    fft_result  = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_LEN);
-    ifft_result = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * FFT_LEN);
+/**
+\brief stop and join the worker thread
+*/
+void SpectrumAnalyzer::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(workerMutex);
+		running = false;
+	}
+	workerWake.notify_all();
+
+	if (worker.joinable())
+		worker.join();
+}
 
-    plan_forward  = fftw_plan_dft_1d(FFT_LEN, data, fft_result, FFTW_FORWARD, FFTW_ESTIMATE);
-    plan_backward = fftw_plan_dft_1d(FFT_LEN, fft_result, ifft_result, FFTW_BACKWARD, FFTW_ESTIMATE);
+/**
+\brief (re)configure: builds the window, FFTW plan and bin-to-pixel maps, then (re)starts the worker
 
-    // --- window
-    setWindow(spectrumViewWindowType::kBlackmanHarrisWindow);
+NOTES:
+- GUI thread only; the FFTW planner is not thread-safe, but fftw_execute( ) on the worker is
+*/
+void SpectrumAnalyzer::configure(uint32_t _numPixels, double _sampleRate, uint32_t _fftLength, uint32_t _overlap, double _averaging, spectrumViewWindowType _window)
+{
+	stop();
+	destroyFFT();
+
+	// --- settings; FFT length to a power of 2 in range
+	numPixels = _numPixels > 0 ? _numPixels : 1;
+	sampleRate = _sampleRate > 0.0 ? _sampleRate : 44100.0;
+	fftLength = SPECTRUM_MIN_FFT_LEN;
+	while (fftLength < _fftLength && fftLength < SPECTRUM_MAX_FFT_LEN)
+		fftLength *= 2;
+	overlap = _overlap > 0 ? _overlap : 1;
+	if (overlap > fftLength) overlap = fftLength;
+	hopSize = fftLength / overlap;
+	averaging = _averaging < 0.0 ? 0.0 : (_averaging > 0.99 ? 0.99 : _averaging);
+	window = _window;
+
+	uint32_t numBins = fftLength / 2 + 1;
+
+	// --- FFTW real-to-complex
+	fftInput = (double*)fftw_malloc(sizeof(double) * fftLength);
+	fftOutput = (fftw_complex*)fftw_malloc(sizeof(fftw_complex) * numBins);
+	plan = fftw_plan_dft_r2c_1d(fftLength, fftInput, fftOutput, FFTW_ESTIMATE);
+
+	// --- window (same shapes as before, now any length)
+	windowTable.assign(fftLength, 0.0);
+	double windowSum = 0.0;
+	for (uint32_t n = 0; n < fftLength; n++)
+	{
+		if (window == spectrumViewWindowType::kHannWindow)
+			windowTable[n] = 0.5 * (1.0 - cos((n*2.0*M_PI) / fftLength));
+		else if (window == spectrumViewWindowType::kBlackmanHarrisWindow)
+			windowTable[n] = 0.42323 - (0.49755*cos((n*2.0*M_PI) / fftLength)) + 0.07922*cos((2 * n*2.0*M_PI) / fftLength);
+		else // --- rectangular
+			windowTable[n] = 1.0;
+
+		windowSum += windowTable[n];
+	}
+
+	// --- a full-scale sine peaks at |X| = windowSum/2
+	powerNormalization = windowSum > 0.0 ? 4.0 / (windowSum*windowSum) : 1.0;
+
+	// --- history and averages
+	history.assign(fftLength, 0.0);
+	historyIndex = 0;
+	historyCount = 0;
+	hopCounter = 0;
+	averagedPower.assign(numBins, 0.0);
+	firstFrame = true;
+	newFrame = false;
+
+	// --- bin-to-pixel maps: pixel x covers [f(x - 0.5), f(x + 0.5)) on a log axis
+	double binWidth = sampleRate / fftLength;
+	double fMin = SPECTRUM_MIN_FREQ;
+	double fMax = SPECTRUM_MAX_FREQ < sampleRate / 2.0 ? SPECTRUM_MAX_FREQ : sampleRate / 2.0;
+	double logRange = log(fMax / fMin);
+
+	pixelBinStart.assign(numPixels, 0);
+	pixelBinEnd.assign(numPixels, 1);
+	pixelBinPosition.assign(numPixels, 0.0);
+	for (uint32_t x = 0; x < numPixels; x++)
+	{
+		double span = numPixels > 1 ? (double)(numPixels - 1) : 1.0;
+		double fLow = fMin * exp(logRange * ((double)x - 0.5) / span);
+		double fCenter = fMin * exp(logRange * (double)x / span);
+		double fHigh = fMin * exp(logRange * ((double)x + 0.5) / span);
+
+		uint32_t binStart = (uint32_t)ceil(fLow / binWidth);
+		uint32_t binEnd = (uint32_t)floor(fHigh / binWidth) + 1;
+		if (binEnd > numBins) binEnd = numBins;
+
+		if (binEnd > binStart + 1)
+		{
+			// --- several bins in this pixel: take the max
+			pixelBinStart[x] = binStart;
+			pixelBinEnd[x] = binEnd;
+		}
+		else
+		{
+			// --- pixel narrower than a bin: interpolate at the center frequency
+			double position = fCenter / binWidth;
+			if (position > numBins - 1) position = numBins - 1;
+			pixelBinPosition[x] = position;
+			pixelBinStart[x] = (uint32_t)position;
+			pixelBinEnd[x] = pixelBinStart[x] + 1;
+		}
+	}
+
+	// --- output double buffer
+	displayBuffer_A.assign(numPixels, 0.0);
+	displayBuffer_B.assign(numPixels, 0.0);
+	double* buffer = nullptr;
+	while (displayBuffersReady.try_dequeue(buffer)) {}
+	while (displayBuffersEmpty.try_dequeue(buffer)) {}
+	displayBuffersEmpty.enqueue(displayBuffer_A.data());
+	displayBuffersEmpty.enqueue(displayBuffer_B.data());
+	currentDisplayBuffer = nullptr;
+
+	// --- go
+	running = true;
+	worker = std::thread(&SpectrumAnalyzer::run, this);
 }
 
-SpectrumView::~SpectrumView()
+/**
+\brief audio thread: queue one sample for the worker
+*/
+void SpectrumAnalyzer::pushValue(double value)
 {
-    fftw_destroy_plan( plan_forward );
-    fftw_destroy_plan( plan_backward );
-
-    fftw_free( data );
-    fftw_free( fft_result );
-    fftw_free( ifft_result );
-
-    if(dataQueue)
-        delete dataQueue;
+	valueQueue.enqueue(value);
 }
 
-void SpectrumView::setWindow(spectrumViewWindowType _window)
+/**
+\brief audio thread: queue a block of samples for the worker
+*/
+void SpectrumAnalyzer::pushBlock(const float* values, uint32_t numValues)
 {
-    window = _window;
-    memset(&fftWindow[0], 0, FFT_LEN*sizeof(double));
+	blockQueue.pushBlock(values, numValues);
+}
 
-    // --- rectangular has fftWindow[0] = 0, fftWindow[FFT_LEN-1] = 0, all other points = 1.0
-    if(window == spectrumViewWindowType::kRectWindow)
-    {
-        for (int n=0;n<FFT_LEN-1;n++)
-            fftWindow[n] = 1.0;
-    }
-    else if(window == spectrumViewWindowType::kHannWindow)
-    {
-        for (int n=0;n<FFT_LEN;n++)
-            fftWindow[n] = (0.5 * (1-cos((n*2.0*M_PI)/FFT_LEN)));
-    }
-    else if(window == spectrumViewWindowType::kBlackmanHarrisWindow)
-    {
-        for (int n=0;n<FFT_LEN;n++)
-            fftWindow[n] = (0.42323 - (0.49755*cos((n*2.0*M_PI)/FFT_LEN))+ 0.07922*cos((2*n*2.0*M_PI)/FFT_LEN));
-    }
-    else // --- default to rectangular
-    {
-        for (int n=1;n<FFT_LEN-1;n++)
-            fftWindow[n] = 1.0;
-    }
+/**
+\brief worker thread: drain the input queues, run frames, publish at most one pixel buffer per wake-up
+*/
+void SpectrumAnalyzer::run()
+{
+	while (running)
+	{
+		double value = 0.0;
+		while (valueQueue.try_dequeue(value))
+			addSample(value);
+
+		const CustomViewDataBlock* block = blockQueue.frontBlock();
+		while (block)
+		{
+			for (uint32_t i = 0; i < block->numValues; i++)
+				addSample(block->data[i]);
+
+			blockQueue.popBlock();
+			block = blockQueue.frontBlock();
+		}
+
+		if (newFrame)
+			publishDisplayBuffer();
+
+		std::unique_lock<std::mutex> lock(workerMutex);
+		workerWake.wait_for(lock, std::chrono::milliseconds(SPECTRUM_WORKER_PERIOD_MSEC), [this] { return !running; });
+	}
 }
 
-bool SpectrumView::addFFTInputData(double inputSample)
+/**
+\brief worker thread: add a sample to the circular history; every hopSize samples run a frame
+*/
+void SpectrumAnalyzer::addSample(double sample)
 {
-    if(fftInputCounter >= FFT_LEN)
-        return false;
+	history[historyIndex++] = sample;
+	if (historyIndex >= fftLength)
+		historyIndex = 0;
 
-    data[fftInputCounter][0] = inputSample*fftWindow[fftInputCounter]; // stick your audio samples in here
-    data[fftInputCounter][1] = 0.0; // use this if your data is complex valued
+	if (historyCount < fftLength)
+		historyCount++;
 
-    fftInputCounter++;
-    if(fftInputCounter == FFT_LEN)
-        return true; // ready for FFT
+	if (++hopCounter < hopSize)
+		return;
 
-    return false;
+	hopCounter = 0;
+
+	// --- wait for one full FFT length before the first frame
+	if (historyCount == fftLength)
+		processFrame();
 }
 
+/**
+\brief worker thread: window the newest fftLength samples, FFT, and average the power spectrum
+*/
+void SpectrumAnalyzer::processFrame()
+{
+	// --- oldest sample is at historyIndex
+	uint32_t readIndex = historyIndex;
+	for (uint32_t n = 0; n < fftLength; n++)
+	{
+		fftInput[n] = history[readIndex] * windowTable[n];
+		if (++readIndex >= fftLength)
+			readIndex = 0;
+	}
+
+	fftw_execute(plan);
+
+	uint32_t numBins = fftLength / 2 + 1;
+	double newWeight = firstFrame ? 1.0 : 1.0 - averaging;
+	double oldWeight = firstFrame ? 0.0 : averaging;
+	for (uint32_t i = 0; i < numBins; i++)
+	{
+		double power = (fftOutput[i][0] * fftOutput[i][0] + fftOutput[i][1] * fftOutput[i][1])*powerNormalization;
+		averagedPower[i] = oldWeight*averagedPower[i] + newWeight*power;
+	}
+
+	firstFrame = false;
+	newFrame = true;
+}
 
-void SpectrumView::pushDataValue(double data)
+/**
+\brief worker thread: map averaged bins to pixels through the precomputed maps and hand the buffer to the GUI
+*/
+void SpectrumAnalyzer::publishDisplayBuffer()
 {
-    if(!dataQueue) return;
+	double* bufferToFill = nullptr;
+	if (!displayBuffersEmpty.try_dequeue(bufferToFill) || !bufferToFill)
+		return; // --- GUI has not drawn the last one yet; try again next wake-up
+
+	uint32_t numBins = fftLength / 2 + 1;
+	double dBRange = -SPECTRUM_DB_FLOOR;
+	for (uint32_t x = 0; x < numPixels; x++)
+	{
+		double power = 0.0;
+		if (pixelBinEnd[x] > pixelBinStart[x] + 1)
+		{
+			for (uint32_t bin = pixelBinStart[x]; bin < pixelBinEnd[x]; bin++)
+				power = averagedPower[bin] > power ? averagedPower[bin] : power;
+		}
+		else
+		{
+			uint32_t bin = pixelBinStart[x];
+			double frac = pixelBinPosition[x] - bin;
+			double nextPower = bin + 1 < numBins ? averagedPower[bin + 1] : averagedPower[bin];
+			power = (1.0 - frac)*averagedPower[bin] + frac*nextPower;
+		}
+
+		// --- dBFS to 0.0 ... 1.0
+		double dB = power > 0.0 ? 10.0*log10(power) : SPECTRUM_DB_FLOOR;
+		double value = (dB + dBRange) / dBRange;
+		bufferToFill[x] = value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+	}
+
+	displayBuffersReady.enqueue(bufferToFill);
+	newFrame = false;
+}
 
-    // --- add data point, make room if needed
-    dataQueue->enqueue(data);
+/**
+\brief GUI thread: is there a new pixel buffer waiting?
+*/
+bool SpectrumAnalyzer::hasNewDisplayBuffer()
+{
+	return displayBuffersReady.peek() != nullptr;
 }
 
-void SpectrumView::updateView()
+/**
+\brief GUI thread: swap in the newest pixel buffer, returning the previous one to the worker
+
+\return the current buffer (numPixels values) or nullptr if no frame has been published yet
+*/
+const double* SpectrumAnalyzer::getDisplayBuffer()
 {
-    // --- grab samples from incoming queue and add to FFT input
-    double audioSample = 0.0;
-    bool success = dataQueue->try_dequeue(audioSample);
-    if(!success) return;
-    bool fftReady = false;
-    while(success)
-    {
-        // --- keep adding values into the array; it will stop when full
-        //     and return TRUE if the FFT buffer is full and we are ready
-        //     to do a FFT
-        if(addFFTInputData(audioSample))
-            fftReady = true; // sticky flag
-
-        // --- for this wave view, we can only show the FFT of the last
-        //     512 points anyway, so we just keep popping them from the queue
-        success = dataQueue->try_dequeue(audioSample);
-    }
+	if (displayBuffersReady.peek())
+	{
+		// --- put current buffer in empty queue
+		if (currentDisplayBuffer)
+			displayBuffersEmpty.try_enqueue(currentDisplayBuffer);
 
-    if(fftReady)
-    {
-        // do the FFT
-        fftw_execute(plan_forward);
+		// --- get next buffer to plot
+		displayBuffersReady.try_dequeue(currentDisplayBuffer);
+	}
 
-        double* bufferToFill = nullptr;
-        fftMagBuffersEmpty->try_dequeue(bufferToFill);
+	return currentDisplayBuffer;
+}
 
-        if(!bufferToFill)
-        {
-            fftReady = false;
-            fftInputCounter = 0;
-            return;
-        }
+/**
+\brief SpectrumView constructor
 
-        int maxIndex = 0;
-        for(int i=0; i<FFT_LEN; i++)
-        {
-            bufferToFill[i] = (getMagnitude(fft_result[i][0], fft_result[i][1]));
-        }
+\param size - the control rectangle
+\param listener - the control's listener (usuall PluginGUI object)
+\param tag - the control ID value
+*/
+SpectrumView::SpectrumView(const VSTGUI::CRect& size, IControlListener* listener, int32_t tag)
+: CControl(size, listener, tag)
+{
+    // --- window (also starts the analyzer)
+    setWindow(spectrumViewWindowType::kBlackmanHarrisWindow);
+}
 
-        // --- normalize the FFT buffer for max = 1.0 (note this is NOT dB!!)
-        normalizeBufferGetFMax(bufferToFill, 512, &maxIndex);
+SpectrumView::~SpectrumView()
+{
+    // --- join the worker before anything else goes away
+    analyzer.stop();
+}
 
-        // 1) homework = do plot in dB
-        // 2) homework = add other windows
-        // 3) homework = plot frequency on log x-axis (HARD!)
+void SpectrumView::setWindow(spectrumViewWindowType _window)
+{
+    window = _window;
+    analyzer.configure((uint32_t)getViewSize().getWidth(), analyzer.getSampleRate(), analyzer.getFFTLength(),
+                       analyzer.getOverlap(), analyzer.getAveraging(), window);
+}
 
-        // --- add the new FFT buffer to the queue
-        fftMagBuffersReady->enqueue(bufferToFill);
+void SpectrumView::setSampleRate(double _sampleRate)
+{
+    if (_sampleRate == analyzer.getSampleRate())
+        return;
 
-        // --- set flags (can reduce number of flags?)
-        fftReady = false;
-        fftInputCounter = 0;
-    }
+    analyzer.configure((uint32_t)getViewSize().getWidth(), _sampleRate, analyzer.getFFTLength(),
+                       analyzer.getOverlap(), analyzer.getAveraging(), window);
+}
 
-    // --- this will set the dirty flag to repaint the view
-    invalid();
+void SpectrumView::setAnalyzerSettings(uint32_t fftLength, uint32_t overlap, double averaging)
+{
+    analyzer.configure((uint32_t)getViewSize().getWidth(), analyzer.getSampleRate(), fftLength, overlap, averaging, window);
+}
+
+void SpectrumView::pushDataValue(double data)
+{
+    // --- add data point; the analyzer's worker consumes it
+    analyzer.pushValue(data);
+}
+
+void SpectrumView::pushDataBlock(const float* data, uint32_t numValues)
+{
+    // --- one copy per buffer; no per-sample enqueue
+    analyzer.pushBlock(data, numValues);
+}
+
+void SpectrumView::updateView()
+{
+    // --- all analysis happens on the analyzer's worker; just repaint when it has something new
+    if(analyzer.hasNewDisplayBuffer())
+        invalid();
 }
 
 void SpectrumView::draw(CDrawContext* pContext)
@@ -349,27 +857,15 @@ void SpectrumView::draw(CDrawContext* pContext)
     pContext->setFrameColor(CColor(32, 0, 255, 200));
     pContext->setLineWidth(plotLineWidth);
 
-    // --- is there a new fftBuffer?
-    if(fftMagBuffersReady->peek())
-    {
-        // --- put current buffer in empty queue
-        if(currentFFTMagBuffer)
-            fftMagBuffersEmpty->try_enqueue(currentFFTMagBuffer);
-
-        // --- get next buffer to plot
-        fftMagBuffersReady->try_dequeue(currentFFTMagBuffer);
-    }
-
-    if(!currentFFTMagBuffer)
+    // --- newest ready buffer (one log-frequency value per pixel)
+    const double* pixelBuffer = analyzer.getDisplayBuffer();
+    if(!pixelBuffer)
         return;
 
-    // --- plot the FFT data
-    double step = 128.0/size.getWidth();
-    double magIndex = 0.0;
+    int numPixels = (int)analyzer.getNumPixels();
 
     // --- plot first point
-    double yn = currentFFTMagBuffer[0];
-    double ypt = size.bottom - size.getHeight()*yn;
+    double ypt = size.bottom - size.getHeight()*pixelBuffer[0];
 
     // --- make sure we leave room for bottom of frame
 	if (ypt > size.bottom - frameWidth)
@@ -378,16 +874,10 @@ void SpectrumView::draw(CDrawContext* pContext)
     // --- setup first point, which is last point for loop below
     CPoint lastPoint(size.left, ypt);
 
-    for (int x = 1; x < size.getWidth()-1; x++)
+    for (int x = 1; x < size.getWidth()-1 && x < numPixels; x++)
     {
-        // --- increment stepper for mag array
-        magIndex += step;
-
-        // --- interpolate to find magnitude at this step
-        yn = interpArrayValue(currentFFTMagBuffer, 128, magIndex);
-
         // --- calculate top (y) value of point
-        ypt = size.bottom - size.getHeight()*yn;
+        ypt = size.bottom - size.getHeight()*pixelBuffer[x];
 
         // --- make sure we leave room for bottom of frame
 		if (ypt > size.bottom - frameWidth)
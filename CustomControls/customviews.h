@@ -17,12 +17,149 @@
 #include "vstgui/vstgui_uidescription.h" // for IController
 
 #include "../PluginKernel/pluginstructures.h"
+#include <algorithm>
 
 namespace VSTGUI {
 
 // --- with an update cycle of ~50mSec, we need at least 2205 samples; this should be more than enough
 const int DATA_QUEUE_LEN = 4096;
 
+// --- block ring for ICustomView::pushDataBlock( ); 256 blocks of 64 values covers > 50mSec of raw audio at 192kHz
+const uint32_t DATA_BLOCK_LEN = 64;			///< values per block
+const uint32_t DATA_BLOCK_QUEUE_LEN = 256;	///< blocks in the ring (power of 2)
+
+/**
+\enum customViewDecimation
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to set the audio-thread pre-decimation of a CustomViewBlockQueue
+
+- kNoDecimation: raw values are queued
+- kMinMaxDecimation: each group of samples is reduced to a (min, max) pair of values
+- kRMSDecimation: each group of samples is reduced to one RMS value
+*/
+enum class customViewDecimation { kNoDecimation, kMinMaxDecimation, kRMSDecimation };
+
+/**
+\struct CustomViewDataBlock
+\ingroup Custom-Views
+\brief
+One fixed-size block of values in a CustomViewBlockQueue; min/max decimated blocks hold interleaved (min, max) pairs.
+*/
+struct CustomViewDataBlock
+{
+	float data[DATA_BLOCK_LEN] = { 0.f };	///< the values
+	uint32_t numValues = 0;					///< number of valid values in data[]
+};
+
+/**
+\class CustomViewBlockQueue
+\ingroup Custom-Views
+\brief
+Lock-free single-producer/single-consumer ring of fixed-size data blocks for ICustomView::pushDataBlock( ).
+
+CustomViewBlockQueue:
+- all storage is allocated up front; the audio thread only copies values and publishes whole blocks
+- optional pre-decimation on the audio thread (min/max pairs or RMS) so only display-resolution data is queued
+- a block is published when it is full; if the GUI falls behind, new values are dropped (never blocks the audio thread)
+- setDecimation( ) must be called before the view is registered with the plugin (it is not thread-safe)
+*/
+class CustomViewBlockQueue
+{
+public:
+	CustomViewBlockQueue() {}
+	~CustomViewBlockQueue() {}
+
+	/** set the decimation type and the number of input samples per output point (GUI thread, before use) */
+	void setDecimation(customViewDecimation _decimation, uint32_t _samplesPerPoint);
+
+	/** audio thread: add values; full blocks are published for the GUI */
+	void pushBlock(const float* values, uint32_t numValues);
+
+	/** GUI thread: get the oldest published block, or nullptr if there is none; call popBlock( ) when done with it */
+	const CustomViewDataBlock* frontBlock();
+
+	/** GUI thread: release the block returned by frontBlock( ) */
+	void popBlock();
+
+	/** number of values dropped because the GUI was not reading */
+	uint32_t getDroppedValueCount() { return droppedValues.load(std::memory_order_relaxed); }
+
+protected:
+	CustomViewDataBlock blocks[DATA_BLOCK_QUEUE_LEN];	///< the ring
+	std::atomic<uint32_t> writeIndex{ 0 };				///< next block the producer publishes
+	std::atomic<uint32_t> readIndex{ 0 };				///< next block the consumer reads
+	std::atomic<uint32_t> droppedValues{ 0 };			///< overflow counter
+
+	// --- producer-side state (audio thread only)
+	CustomViewDataBlock* currentBlock = nullptr;		///< block being filled; nullptr if the ring is full
+	customViewDecimation decimation = customViewDecimation::kNoDecimation; ///< decimation type
+	uint32_t samplesPerPoint = 1;						///< decimation factor
+	uint32_t pointCounter = 0;							///< samples accumulated into the current point
+	float pointMin = 0.f;								///< running min for the current point
+	float pointMax = 0.f;								///< running max for the current point
+	double pointSumSquares = 0.0;						///< running sum of squares for the current point
+
+	/** write one output value into the current block; publishes it when full */
+	void writeValue(float value);
+};
+
+// --- waveform pyramid: level 0 is one (min, max) point per WAVEVIEW_SAMPLES_PER_POINT samples; each level up halves the rate
+const uint32_t WAVEVIEW_SAMPLES_PER_POINT = 32;	///< samples reduced into one level-0 point
+const uint32_t WAVEFORM_PYRAMID_LEVELS = 10;	///< level 9 = 16384 samples per point (> 2 minutes across a 400 pixel view at 44.1kHz)
+const uint32_t WAVEVIEW_DEFAULT_ZOOM = 6;		///< 2048 samples per pixel; scrolls at about the original one-pixel-per-timer-ping rate
+
+/**
+\class WaveformPyramid
+\ingroup Custom-Views
+\brief
+Multi-resolution (mip-level) min/max history for WaveView.
+
+WaveformPyramid:
+- level 0 receives (min, max) points; every two points at level n are merged into one point at level n+1 as they arrive
+- each level keeps the newest "length" points in its own circular buffer, so any zoom level can be drawn at once
+- points are addressed by their absolute index at a level; getPointCount( ) tells the view what is new since its last paint
+- GUI thread only
+*/
+class WaveformPyramid
+{
+public:
+	WaveformPyramid() {}
+	~WaveformPyramid() {}
+
+	/** allocate each level to hold _length points and clear */
+	void init(uint32_t _length);
+
+	/** clear all levels */
+	void clear();
+
+	/** add a new level-0 point and carry it up the pyramid */
+	void addPoint(float pointMin, float pointMax);
+
+	/** total number of points ever written to a level (absolute index of the next point) */
+	uint64_t getPointCount(uint32_t level) { return level < WAVEFORM_PYRAMID_LEVELS ? levels[level].count : 0; }
+
+	/** get a point by absolute index; returns false if it has scrolled out of the history (or was never written) */
+	bool getPoint(uint32_t level, uint64_t index, float& pointMin, float& pointMax);
+
+	/** number of points each level holds */
+	uint32_t getLength() { return length; }
+
+protected:
+	struct PyramidLevel
+	{
+		std::vector<float> minBuffer;	///< circular min history
+		std::vector<float> maxBuffer;	///< circular max history
+		uint64_t count = 0;				///< points written so far
+		float pendingMin = 0.f;			///< first half of the next point for the level above
+		float pendingMax = 0.f;			///< first half of the next point for the level above
+		bool hasPending = false;		///< true when one point is waiting for its partner
+	};
+
+	PyramidLevel levels[WAVEFORM_PYRAMID_LEVELS];	///< the mip levels
+	uint32_t length = 0;							///< points per level
+};
+
 /**
 \class WaveView
 \ingroup Custom-Views
@@ -31,11 +168,13 @@ This object displays an audio histogram waveform view.\n
 
 WaveView:
 - uses a lock-free ring buffer for queueing up input data from the plugin
-- implements ICustomView::pushDataValue() and ICustomView::updateView()
-- the updateData() function finds the largest value that was pushed into
-the data queue and adds that to the waveform buffer (circular)
-- uses a circular buffer to make waveform appear to scroll
-- each new input point pushes oldest sample out of the buffer
+- implements ICustomView::pushDataValue(), ICustomView::pushDataBlock() and ICustomView::updateView()
+- data blocks are reduced to min/max pairs on the audio thread (see CustomViewBlockQueue)
+- the updateView() function adds the new min/max points to a WaveformPyramid so the view can zoom from
+WAVEVIEW_SAMPLES_PER_POINT samples per pixel out to minutes of reverb tail (setZoomLevel( ))
+- the plot lives in an offscreen bitmap used as a circular buffer of pixel columns: each update strokes only
+the newly scrolled-in columns, and draw( ) just blits the two halves of the ring
+- newest data is at the left edge; each new point pushes the oldest column out
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
@@ -54,19 +193,30 @@ public:
 	/** ICustomView method: push a new audio sample into the ring buffer */
 	virtual void pushDataValue(double data) override;
 
-	/** add a new point to the circular buffer for painting
-	\param fSample the absolute value of the sample
+	/** ICustomView method: push a block of audio samples; decimated to min/max pairs on the audio thread */
+	virtual void pushDataBlock(const float* data, uint32_t numValues) override;
+
+	/** add a new point to the waveform history for painting
+	\param fSample the absolute value of the sample (drawn symmetrically)
 	*/
 	void addWaveDataPoint(float fSample);
 
-	/** reset the circular buffer for a new run
+	/** reset the waveform history for a new run
 	*/
 	void clearBuffer();
 
 	/** toggles showng of x axis
 	\param _paintXAxis enable/disable functionality
 	*/
-	void showXAxis(bool _paintXAxis) { paintXAxis = _paintXAxis; }
+	void showXAxis(bool _paintXAxis) { paintXAxis = _paintXAxis; repaintAll = true; }
+
+	/** set the zoom (pyramid level); each pixel column covers WAVEVIEW_SAMPLES_PER_POINT * 2^level samples
+	\param level the pyramid level, 0 to WAVEFORM_PYRAMID_LEVELS - 1
+	*/
+	void setZoomLevel(uint32_t level);
+
+	/** get the current zoom (pyramid level) */
+	uint32_t getZoomLevel() { return zoomLevel; }
 
 	/** override of drawing function
 	\param pContext incoming draw context
@@ -80,22 +230,46 @@ protected:
     // --- turn on/off zerodB line
     bool paintXAxis = true; ///< flag for painting X Axis
 
-    // --- circular buffer and index values
-    double* circularBuffer = nullptr;	///< circular buffer to store peak values
-    int writeIndex = 0;		///< circular buffer write location
-    int readIndex = 0;		///< circular buffer read location
-    int circularBufferLength = 0;///< circular buffer length
+    // --- min/max history and zoom
+    WaveformPyramid pyramid;	///< multi-resolution min/max history
+    uint32_t zoomLevel = WAVEVIEW_DEFAULT_ZOOM; ///< pyramid level being displayed
+    int circularBufferLength = 0;///< number of pixel columns (= view width)
 	CRect currentRect;		///< the rect to draw into
 
+	// --- GUI-side reduction of values from pushDataValue( )
+	uint32_t valueCounter = 0;	///< values accumulated into the current point
+	float valueMin = 0.f;		///< running min
+	float valueMax = 0.f;		///< running max
+
+	// --- offscreen plot, used as a circular buffer of pixel columns
+	SharedPointer<COffscreenContext> plotContext;	///< the offscreen plot
+	uint64_t renderedCount = 0;	///< pyramid point count (at zoomLevel) already stroked into plotContext
+	bool repaintAll = true;		///< re-render every column (zoom change, clear, first paint)
+
+	/** stroke any columns not yet in the offscreen plot; creates the offscreen on first use */
+	void renderNewColumns();
+
+	/** stroke one column of the plot
+	\param pContext the context to draw into
+	\param x the pixel column
+	\param index absolute pyramid index of the point at zoomLevel
+	*/
+	void drawColumn(CDrawContext* pContext, CCoord x, uint64_t index);
+
 private:
     // --- lock-free queue for incoming data, sized to DATA_QUEUE_LEN in length
     moodycamel::ReaderWriterQueue<double, DATA_QUEUE_LEN>* dataQueue = nullptr; ///< lock-free queue for incoming data, sized to DATA_QUEUE_LEN in length
 
+	// --- block queue for pushDataBlock( ), min/max decimated
+	CustomViewBlockQueue* blockQueue = nullptr; ///< lock-free block ring for incoming data blocks
 };
 
 #ifdef HAVE_FFTW
 // --- FFTW (REQUIRED)
 #include "fftw3.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 /**
 \enum spectrumViewWindowType
@@ -112,9 +286,140 @@ Use this strongly typed enum to easily set the window type for the spectrum view
 */
 enum class spectrumViewWindowType {kRectWindow, kHannWindow, kBlackmanHarrisWindow};
 
-// --- change this for higher accuracy; needs to be power of 2
+// --- per-sample queue block size; the analyzer itself is configurable up to SPECTRUM_MAX_FFT_LEN
 const int FFT_LEN = 512;
 
+// --- analyzer limits and defaults
+const uint32_t SPECTRUM_MIN_FFT_LEN = 256;			///< smallest FFT (power of 2)
+const uint32_t SPECTRUM_MAX_FFT_LEN = 16384;		///< largest FFT (power of 2); 2.7Hz bins at 44.1kHz
+const uint32_t SPECTRUM_DEFAULT_FFT_LEN = 4096;		///< 10.8Hz bins at 44.1kHz: enough to see plate damping below 200Hz
+const uint32_t SPECTRUM_DEFAULT_OVERLAP = 4;		///< frames per FFT length (75% overlap)
+const double SPECTRUM_DEFAULT_AVERAGING = 0.7;		///< exponential averaging coefficient per frame (0 = none)
+const double SPECTRUM_MIN_FREQ = 20.0;				///< left edge of the log-frequency axis
+const double SPECTRUM_MAX_FREQ = 20000.0;			///< right edge of the log-frequency axis (clamped to Nyquist)
+const double SPECTRUM_DB_FLOOR = -96.0;				///< bottom of the display in dBFS
+const uint32_t SPECTRUM_WORKER_PERIOD_MSEC = 10;	///< worker wake-up period
+
+/**
+\class SpectrumAnalyzer
+\ingroup Custom-Views
+\brief
+Log-frequency spectrum analyzer engine for SpectrumView; does all of its work on its own (GUI-side) worker thread.
+
+SpectrumAnalyzer:
+- real FFT (FFTW r2c) of 256 to 16384 points with overlapped frames (hop = fftLength / overlap)
+- per-bin exponential averaging of the power spectrum
+- log-frequency aggregation to one value per pixel using bin-to-pixel maps precomputed in configure( ):
+pixels wider than a bin take the max over their bins, narrower pixels interpolate between the two nearest bins
+- values are in dBFS (a full-scale sine reads 0dB), mapped to 0.0 (SPECTRUM_DB_FLOOR) ... 1.0 (0dB)
+- input arrives through lock-free queues (pushValue( ), pushBlock( )) whose consumer is the worker
+- finished pixel buffers are handed to the draw code with the same ready/empty double-buffer queues as before,
+so draw( ) never waits and never computes
+- configure( ) stops the worker, rebuilds the FFTW plan and the maps, and restarts it (GUI thread only)
+*/
+class SpectrumAnalyzer
+{
+public:
+	SpectrumAnalyzer();
+	~SpectrumAnalyzer();
+
+	/** (re)configure and (re)start the worker; fftLength is rounded to a power of 2 and clamped to 256 ... 16384
+	\param _numPixels the number of output values (the view width)
+	\param _sampleRate the sample rate of the incoming audio
+	\param _fftLength the FFT length
+	\param _overlap frames per FFT length (1 = no overlap)
+	\param _averaging exponential averaging coefficient, 0.0 (none) to < 1.0
+	\param _window the window type
+	*/
+	void configure(uint32_t _numPixels, double _sampleRate, uint32_t _fftLength, uint32_t _overlap, double _averaging, spectrumViewWindowType _window);
+
+	/** stop and join the worker thread */
+	void stop();
+
+	/** audio thread: queue one sample */
+	void pushValue(double value);
+
+	/** audio thread: queue a block of samples */
+	void pushBlock(const float* values, uint32_t numValues);
+
+	/** GUI thread: true if the worker has published a new pixel buffer */
+	bool hasNewDisplayBuffer();
+
+	/** GUI thread: get the newest pixel buffer (numPixels values, 0.0 to 1.0), or nullptr before the first frame */
+	const double* getDisplayBuffer();
+
+	/** get settings */
+	uint32_t getNumPixels() { return numPixels; }
+	uint32_t getFFTLength() { return fftLength; }
+	uint32_t getOverlap() { return overlap; }
+	double getAveraging() { return averaging; }
+	double getSampleRate() { return sampleRate; }
+	spectrumViewWindowType getWindow() { return window; }
+
+protected:
+	// --- settings
+	uint32_t numPixels = 0;			///< output values per frame
+	double sampleRate = 44100.0;	///< input sample rate
+	uint32_t fftLength = SPECTRUM_DEFAULT_FFT_LEN; ///< FFT length
+	uint32_t overlap = SPECTRUM_DEFAULT_OVERLAP;	///< frames per FFT length
+	uint32_t hopSize = SPECTRUM_DEFAULT_FFT_LEN / SPECTRUM_DEFAULT_OVERLAP; ///< samples between frames
+	double averaging = SPECTRUM_DEFAULT_AVERAGING;	///< averaging coefficient
+	spectrumViewWindowType window = spectrumViewWindowType::kBlackmanHarrisWindow; ///< window type
+
+	// --- FFTW
+	double* fftInput = nullptr;			///< windowed real input
+	fftw_complex* fftOutput = nullptr;	///< fftLength/2 + 1 complex bins
+	fftw_plan plan = nullptr;			///< r2c plan
+
+	// --- worker-side state
+	std::vector<double> windowTable;	///< window, fftLength points
+	double powerNormalization = 1.0;	///< scales power so a full-scale sine reads 1.0 (0dB)
+	std::vector<double> history;		///< circular input history, fftLength points
+	uint32_t historyIndex = 0;			///< next write location in history
+	uint32_t hopCounter = 0;			///< samples since the last frame
+	uint32_t historyCount = 0;			///< samples in history (until full)
+	std::vector<double> averagedPower;	///< averaged power per bin
+	bool firstFrame = true;				///< seeds the average
+	bool newFrame = false;				///< a frame was computed since the last publish
+
+	// --- bin-to-pixel maps (precomputed)
+	std::vector<uint32_t> pixelBinStart;	///< first bin for each pixel
+	std::vector<uint32_t> pixelBinEnd;		///< one past the last bin for each pixel (== start + 1 means interpolate)
+	std::vector<double> pixelBinPosition;	///< fractional bin at the pixel center (for interpolation)
+
+	// --- output double buffer
+	std::vector<double> displayBuffer_A;	///< 1/2 of the double buffer
+	std::vector<double> displayBuffer_B;	///< 1/2 of the double buffer
+	double* currentDisplayBuffer = nullptr;	///< buffer the draw code holds (GUI thread only)
+	moodycamel::ReaderWriterQueue<double*, 2> displayBuffersReady;	///< worker -> GUI
+	moodycamel::ReaderWriterQueue<double*, 2> displayBuffersEmpty;	///< GUI -> worker
+
+	// --- input queues (audio thread -> worker)
+	moodycamel::ReaderWriterQueue<double, FFT_LEN> valueQueue;	///< per-value input
+	CustomViewBlockQueue blockQueue;							///< block input
+
+	// --- worker thread
+	std::thread worker;					///< the worker
+	std::atomic<bool> running{ false };	///< worker run flag
+	std::mutex workerMutex;				///< for the wake-up condition
+	std::condition_variable workerWake;	///< wakes the worker early (stop)
+
+	/** worker thread loop */
+	void run();
+
+	/** add one sample to the history; runs a frame every hopSize samples */
+	void addSample(double sample);
+
+	/** window, FFT, and average one frame from the history */
+	void processFrame();
+
+	/** map the averaged spectrum to pixels and publish it */
+	void publishDisplayBuffer();
+
+	/** free FFTW memory and plan */
+	void destroyFFT();
+};
+
 // --- SpectrumView
 /*
 */
@@ -122,18 +427,14 @@ const int FFT_LEN = 512;
 \class SpectrumView
 \ingroup Custom-Views
 \brief
-This object displays the FFT of the incoming data.\n
+This object displays the log-frequency spectrum of the incoming data.\n
 
 SpectrumView:
-- uses a lock-free ring buffer for queueing up input data from the plugin
-- implements ICustomView::pushDataValue() and ICustomView::updateData()
-- uses a pair of lock-free ring buffers to implement a safe double-buffering system
-- during updates, the queue is dumped into the FFT array
-- when a new FFT is processed, its magnitude array is calculated in the first
-available buffer in the empty queue; it is then placed in the filled (ready) queue
-- the draw() function is on the same thread with the PluginKernel/PluginGUI paradigm\
-but just in case it ISN'T, the drawing uses the double buffer to safely get the
-next available magnitude array to display
+- implements ICustomView::pushDataValue(), ICustomView::pushDataBlock() and ICustomView::updateView()
+- the data goes straight to a SpectrumAnalyzer, which does the FFT, averaging and log-frequency
+mapping on its own worker thread
+- updateView() only checks for a new pixel buffer; draw() only plots it (one value per pixel column)
+- the analyzer uses a pair of lock-free ring buffers to implement a safe double-buffering system
 - the result is a super fast visually synchronized display
 
 \author Will Pirkle http://www.willpirkle.com
@@ -153,6 +454,9 @@ public:
 	/** ICustomView method: push a new audio sample into the ring buffer */
 	virtual void pushDataValue(double data) override;
 
+	/** ICustomView method: push a block of audio samples (raw; the FFT needs every sample) */
+	virtual void pushDataBlock(const float* data, uint32_t numValues) override;
+
 	/** show FFT as filled (or unfilled) plot */
 	void showFilledFFT(bool _filledFFT) { filledFFT = _filledFFT; }
 
@@ -161,6 +465,18 @@ public:
 	*/
 	void setWindow(spectrumViewWindowType _window);
 
+	/** set the sample rate of the data being pushed (for the frequency axis); default is 44.1kHz
+	\param _sampleRate the sample rate
+	*/
+	void setSampleRate(double _sampleRate);
+
+	/** set the analyzer resolution
+	\param fftLength FFT length, 256 to 16384 (power of 2)
+	\param overlap frames per FFT length (1 = no overlap)
+	\param averaging exponential averaging coefficient, 0.0 (none) to < 1.0
+	*/
+	void setAnalyzerSettings(uint32_t fftLength, uint32_t overlap, double averaging);
+
 	/** override to draw, called if the view should draw itself*/
 	void draw(CDrawContext* pContext) override;
 
@@ -170,114 +486,13 @@ public:
 protected:
     // --- for windowing; this doesn't need to be saved in current
     //     implementation but you may need it for homework/upgrading the object
-	spectrumViewWindowType window = spectrumViewWindowType::kRectWindow; ///< window type
-
-    // --- setup FFTW
-    fftw_complex* data = nullptr;			///< fft input data
-	fftw_complex* fft_result = nullptr;		///< fft output data
-	fftw_complex* ifft_result = nullptr;	///< ifft output (not used)
-	fftw_plan plan_forward;					///< plan for FFT
-	fftw_plan plan_backward;				///< plan for IFFT (not used)
+	spectrumViewWindowType window = spectrumViewWindowType::kBlackmanHarrisWindow; ///< window type
 
-    // --- for FFT data input
-    int fftInputCounter = 0;				///< input counter for FFT
+	// --- the analyzer engine and its worker
+	SpectrumAnalyzer analyzer; ///< FFT, averaging, log-frequency mapping
 
- 	/** returns true if the input buffer is full and ready for a FFT operation \n
-	will keep track of indexing and reject samples when full
-	\param inputSample input point for FFT
-	*/
-    bool addFFTInputData(double inputSample);
-
-    // --- a double buffer pair of magnitude arrays
-    double fftMagnitudeArray_A[FFT_LEN] = {0.0}; ///< 1/2 of double buffer (yes this is overkill but showing as demonstration!!)
-    double fftMagnitudeArray_B[FFT_LEN] = {0.0}; ///< 1/2 of double buffer (yes this is overkill but showing as demonstration!!)
-
-    // --- buffer for the assigned window
-    double fftWindow[FFT_LEN] = {1.0}; ///< window buffer
-
-    // --- pointer to mag buffer that drawing thread uses; note that
-    //     this pointer is never shared with any other function
-    double* currentFFTMagBuffer = nullptr; ///< poitner to current FFT buffer
-
-    // --- NOTE: move these to another file for use by other objects!!
-    // --- helper for FFT magnitude
-    inline double getMagnitude(double re, double im)
-    {
-        return sqrt((re*re)+(im*im));
-    }
-
-	/** normalize a buffer and find the index of the maximum value at the same time
-	\param buffer - pointer to buffer to normalize
-	\param bufferSize - length of buffer
-	\param ptrMaxIndex - return value passed by pointer of INDEX of max value in buffer
-	*/
-	inline double normalizeBufferGetFMax(double* buffer, unsigned int bufferSize, int* ptrMaxIndex)
-    {
-        double max = 0;
-        double maxRetValue = 0;
-        *ptrMaxIndex = 0;
-
-        for(int j=0; j<bufferSize; j++)
-        {
-            if((fabs(buffer[j])) > max)
-            {
-                max = fabs(buffer[j]);
-                *ptrMaxIndex = j;
-            }
-        }
-
-        if(max > 0)
-        {
-            for(int j=0; j<bufferSize; j++)
-            {
-                buffer[j] = buffer[j]/max;
-                if(j == *ptrMaxIndex)
-                    maxRetValue = buffer[j];
-            }
-        }
-
-        return maxRetValue;
-    }
-
-	/** interpolate a value from an array
-	\param array - pointer to array to interpolate
-	\param arraySize - length of array
-	\param fractionalIndex - fractional location of value in array (e.g. 3.446 is 0.446 between 3 and 4)
-	*/
-	inline double interpArrayValue(double* array, int arraySize, double fractionalIndex)
-    {
-        // --- extract [index_x] values
-        int x1 = (int)fractionalIndex;
-        int x2 = x1 + 1;
-
-        // --- check invalid conditions
-        if(x1 >= arraySize)
-            return 0.0;
-        if(x2 >= arraySize)
-            return array[x1];
-        if(x2 - x1 == 0)    // 0 slope: should not ever happen
-            return array[x1];
-
-        // --- calculate decimal position of x
-        double dx = (fractionalIndex - x1)/(x2 - x1);
-
-        // --- use weighted sum method of interpolating
-        return dx*array[x2] + (1-dx)*array[x1];
-    }
-
-protected:
     // --- filled/unfilled FFT
     bool filledFFT = true; ///< flag for filled FFT
-
-private:
-    // --- lock-free queue for incoming data, sized to FFT_LEN in length
-    moodycamel::ReaderWriterQueue<double,FFT_LEN>* dataQueue = nullptr; ///< lock free ring buffer
-
-    // --- a pair of lock-free queues to store empty and full magnitude buffers
-    //     these are setup as double buffers but you can easily extend them
-    //     to quad (4) and octal (8) if you want
-    moodycamel::ReaderWriterQueue<double*,2>* fftMagBuffersReady = nullptr; ///< example of queuing system (yes I know it is overkill here)
-    moodycamel::ReaderWriterQueue<double*,2>* fftMagBuffersEmpty = nullptr; ///< example of queuing system (yes I know it is overkill here)
 };
 #endif // defined FFTW
 
@@ -27,11 +27,94 @@ enum controlID {
 	lowpass_freq = 3,
 	mod_rate = 4,
 	mod_dpeth = 5,
-	predelay_time = 10
+	predelay_time = 10,
+	engine = 11,
+	cross_feed = 12
 };
 
 	// **--0x0F1F--**
 
+// --- tank sleeps once input and tail have been below this level long enough (-120 dBFS)
+const double kTankSilenceThreshold_dB = -120.0;
+const double kTankSilenceThreshold = 1.0e-6;
+
+// --- high quality (offline) engine: tank oversampling and the Butterworth sections around it (cutoff relative to host sample rate)
+const uint32_t kOfflineOversamplingRatio = 2;
+const uint32_t kNumResamplingFilterStages = 3;
+const double kResamplingFilter_fc = 0.45;
+
+// --- reduced rate tank (real-time, high host rates): the tank drops to 1/2 or 1/4 rate behind half-band filters
+//     as long as the rate stays at or above kMinReducedTankSampleRate and the passband (kHalfBandPassband x tank rate)
+//     covers the whole Low Pass and Damping range, up to kMaxTankBandwidth; the wet path lag it adds (about 0.1 mSec)
+//     comes out of the pre-delay, and out of the dry path (up to kMaxTankLag_mSec) when the pre-delay is shorter
+const uint32_t kMaxTankDecimationRatio = 4;
+const double kMaxTankLag_mSec = 0.5;
+const double kMinReducedTankSampleRate = 44100.0;
+const double kMaxTankBandwidth = 20000.0;
+const double kHalfBandPassband = 0.42;
+const unsigned int kHalfBandCoefficients = 8;			// --- sharp stage next to the tank: flat to 0.21, -100dB from 0.29 (x its input rate)
+const double kHalfBandTransition = 0.04;
+const unsigned int kHalfBandOuterCoefficients = 4;		// --- outer 4x stage only has to protect the inner stage's passband
+const double kHalfBandOuterTransition = 0.13;
+
+// --- storage of the long recirculating lines (delay1..delay4 and the FDN): float halves their cache and memory
+//     footprint and is still 24 bits below the signal; the short diffuser/APF lines stay double
+const bufferStorage kTankLineStorage = bufferStorage::kFloat;
+
+// --- initialize( ) sizes the delay lines for this rate (times kOfflineOversamplingRatio) so reset( ) does not allocate
+const double kMaxPreparedSampleRate = 192000.0;
+
+// --- sub-blocks are run through the input diffuser in passes of up to this many frames (see processDiffuserBlock( ))
+const uint32_t kDiffuserBlockSize = 128;
+
+// --- FDN engine: delay line spread (plate-sized, shorter than a room) and line count per Engine setting
+const double kFDNMinDelay_mSec = 12.0;
+const double kFDNMaxDelay_mSec = 48.0;
+const unsigned int kFDNLinesPerEngine[4] = { 0, 8, 16, 32 };
+
+// --- engine switches: the old engine's wet output fades out over this time before the tank is flushed
+const double kTankSwitchFade_mSec = 10.0;
+
+// --- true stereo engine: Cross-Feed below this is taken as 0 (independent tanks); the smoother only gets to 0 asymptotically
+const double kMinCrossFeed_Percent = 0.001;
+
+// --- surround outputs (5.0, 5.1, 7.1): one tank, a decorrelated tap set per output channel; the tank outputs are
+//     L, R, C, Ls, Rs and the extra 7.1 pair (DTS: sides, SDDS: Lc/Rc front centers), LFE gets no reverb (see setPlateChannelLayout( ))
+const uint32_t kMaxTankOutputs = 7;
+const uint32_t kMaxPlateChannels = 8;
+const uint32_t kCenterTankOutput = 2;
+const int32_t kNoPlateChannel = -1;
+const double kSurroundFoldDownGain = 0.70710678;	// --- C and the surrounds into the tank input (-3dB)
+const uint32_t kSurroundPairTankOutput = 5;			// --- first tank output of the extra 7.1 pair
+const double kFrontCenterFoldGain = 0.92387953;		// --- SDDS Lc/Rc into their own side of the tank input (constant power, halfway to C)
+const double kFrontCenterCrossFoldGain = 0.38268343;	// --- SDDS Lc/Rc into the other side
+
+// --- tank line lengths in samples at 44.1kHz, in order around the tank: delay1, apf5, delay2, delay3, apf6, delay4
+//     (see createDelayBuffers( )); the buffers round up to a power of two, so a longer tap can wrap
+const uint32_t kNumTankLines = 6;
+constexpr double kTankLineLength[kNumTankLines] = { 6241, 3932, 6590, 5369, 2665, 5505 };
+
+// --- tap sets of the tank outputs after L and R, in samples at 44.1kHz like the stereo taps (see readTankTapSet( ));
+//     each set has the shape of the stereo ones: two taps on its first line and one on each of the other five,
+//     starting on delay1 (left half of the figure-eight) or on delay3 (right half)
+const uint32_t kNumSurroundTapSets = kMaxTankOutputs - 2;
+constexpr double kSurroundTapTimes[kNumSurroundTapSets][7] = {
+	{ 1051, 5227, 1693, 4432, 1486, 1119, 3217 },	// --- C
+	{ 2267, 5873, 3502, 1290, 4157, 2148, 611 },	// --- Ls
+	{ 1784, 4791, 743, 2365, 1719, 2473, 5211 },	// --- Rs
+	{ 3719, 818, 1147, 3683, 3361, 2489, 4608 },	// --- 7.1 left side/center
+	{ 3029, 917, 1387, 5077, 4873, 3833, 2389 } };	// --- 7.1 right side/center
+constexpr bool kSurroundTapSetRightHalf[kNumSurroundTapSets] = { false, false, true, false, true };
+
+// --- tap n (set n/7, tap n%7) and every one after it stays inside the line readTankTapSet( ) reads it from
+constexpr bool surroundTapsFitTankLines(uint32_t n = 0)
+{
+	return n >= kNumSurroundTapSets * 7 ||
+		(kSurroundTapTimes[n / 7][n % 7] < kTankLineLength[((kSurroundTapSetRightHalf[n / 7] ? 3 : 0) + (n % 7 == 0 ? 0 : n % 7 - 1)) % kNumTankLines] &&
+		 surroundTapsFitTankLines(n + 1));
+}
+static_assert(surroundTapsFitTankLines(), "a surround tap is longer than its tank line");
+
 /**
 \class PluginCore
 \ingroup ASPiK-Core
@@ -77,9 +160,11 @@ public:
 	/** process frames of data */
 	virtual bool processAudioFrame(ProcessFrameInfo& processFrameInfo);
 
-	// --- uncomment and override this for buffer processing; see base class implementation for
-	//     help on breaking up buffers and getting info from processBufferInfo
-	//virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
+	/** buffer processing; bypasses the frame loop entirely while the reverb tank is asleep */
+	virtual bool processAudioBuffers(ProcessBufferInfo& processBufferInfo);
+
+	/** render a scheduler sub-block from float or double (VST3 kSample64) buffers without the frame loop */
+	virtual bool processAudioSubBlock(ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t numFrames);
 
 	/** preProcess: do any post-buffer processing required; default operation is to send metering data to GUI  */
 	virtual bool postProcessAudioBuffers(ProcessBufferInfo& processInfo);
@@ -110,10 +195,7 @@ public:
 
 	// --- BEGIN USER VARIABLES AND FUNCTIONS -------------------------------------- //
 	//	   Add your variables and methods here
-	DelayAPF apf1;
-	DelayAPF apf2;
-	DelayAPF apf3;
-	DelayAPF apf4;
+	InputDiffuser inputDiffuser;
 	DelayAPF apf5;
 	DelayAPF apf6;
 	SimpleDelay delay1;
@@ -128,9 +210,242 @@ public:
 	double x1 = 0.0;
 	double x2 = 0.0;
 	double x3 = 0.0;
+	bool enableAntiDenormal = true; ///< inject kAntiDenormalOffset into the tank feedback nodes
 
 	void UpdateParameters();
 
+	// --- the plate itself, shared by the frame and sub-block paths; yn holds numTankOutputs wet outputs
+	void processPlate(double xnL, double xnR, double* yn);
+	void processTank(double xn, double* yn);
+	void processTankLoop(double diffused, double* yn);
+	void processFDNTank(double xn, double* yn);
+	void processTankEngine(double xnL, double xnR, double* yn);
+	void processReducedRateTank();
+
+	// --- channel layouts: stereo and surround outputs from the one tank
+	bool setPlateChannelLayout(uint32_t inputFormat, uint32_t outputFormat);
+	void processSurroundFrame(const double* input, double* output);
+	void readSurroundTaps(double* yn);
+	double readTankTapSet(const double* tapTimes, bool rightHalf, unsigned int lane);
+	double readTankLine(uint32_t line, double tap_Samples, unsigned int lane);
+	uint32_t layoutInputFormat = kCFNone;			///< formats of the current layout
+	uint32_t layoutOutputFormat = kCFNone;
+	bool plateLayoutValid = false;					///< the current formats have a tank (FX, stereo or surround out)
+	uint32_t numTankOutputs = 2;					///< wet outputs the tank renders: 2, 5 or 7
+	uint32_t numPlateInputChannels = 2;				///< channels of the current input format
+	uint32_t numPlateOutputChannels = 2;			///< channels of the current output format
+	int32_t plateOutputTank[kMaxPlateChannels] = { 0 };	///< tank output of each output channel, or kNoPlateChannel (LFE)
+	int32_t plateDryInput[kMaxPlateChannels] = { 0 };	///< input channel of each output channel's dry signal, or kNoPlateChannel
+	double inputFoldLeft[kMaxPlateChannels] = { 0.0 };	///< input channel gains into the left tank input
+	double inputFoldRight[kMaxPlateChannels] = { 0.0 };	///< input channel gains into the right tank input
+
+	// --- FDN engine, selected with the Engine parameter; the plate's decay and damping controls drive it too
+	void updateFDNParameters();
+	FDNReverb fdn;
+	bool fdnEngineActive = false;		///< engine running now; a change flushes both engines
+
+	// --- true stereo engine: left and right each drive their own copy of the plate, run as the two lanes of the
+	//     stereo lane objects; Cross-Feed rotates the tank feedback between the lanes
+	void updateTrueStereoParameters();
+	void processTrueStereoTank(double xnL, double xnR, double* yn);
+	void processTrueStereoTankLoop(const double* diffused, double* yn);
+	bool trueStereoEngineActive = false;	///< engine running now; a change flushes every engine
+	StereoLaneDelay stereoPreDelay;			///< preDelay, both lanes
+	StereoLaneFilter stereoLPF[3];			///< LPF[0..2], both lanes
+	InputDiffuser rightInputDiffuser;		///< right lane diffusers; the left lane uses inputDiffuser
+	StereoLaneDelayAPF stereoModAPF[2];		///< modAPF1, modAPF2
+	StereoLaneDelayAPF stereoAPF[2];		///< apf5, apf6
+	StereoLaneDelay stereoDelay[4];			///< delay1..delay4
+	double stereoX3[NUM_STEREO_LANES] = { 0.0, 0.0 };	///< x3 (tank feedback) per lane
+	double crossFeedCos = 1.0;				///< feedback rotation: cos of the cross-feed angle
+	double crossFeedSin = 0.0;				///< feedback rotation: sin of the cross-feed angle, 0 = independent tanks
+
+	// --- engine selection: offline renders run the tank oversampled (see reset( ))
+	void initResamplingFilters(double sampleRate);
+	void createDelayBuffers(double sampleRate);
+	void prepareTank(double sampleRate);
+	uint32_t oversamplingRatio = 1;								///< tank runs at engineSampleRate = sampleRate*oversamplingRatio
+	double engineSampleRate = 44100.0;							///< sample rate of the tank objects
+	AudioFilter upsampleLPF[2][kNumResamplingFilterStages];	///< anti-imaging filters for the zero-stuffed tank inputs
+	AudioFilter downsampleLPF[kMaxTankOutputs][kNumResamplingFilterStages];	///< anti-aliasing filters for the tank outputs
+
+	// --- reduced rate tank for high host rates (real-time only, see chooseTankDecimationRatio( ))
+	uint32_t chooseTankDecimationRatio(double sampleRate);
+	bool enableReducedRateTank = true;								///< allow the tank to run at 1/2 or 1/4 of the host rate
+	uint32_t decimationRatio = 1;									///< tank runs at engineSampleRate = sampleRate/decimationRatio
+	double tankLag_mSec = 0.0;										///< wet path lag of the reduced rate tank, 0 at the host rate
+	double dryDelay_mSec = 0.0;										///< part of tankLag_mSec the pre-delay is too short to take
+	SimpleDelay dryDelay[kMaxPlateChannels];						///< dry signal of each output channel, lined up with the wet one
+
+	/** dry signal of an output channel, delayed by dryDelay_mSec; written whenever the tank lags, so a later
+	    pre-delay change reads a full line */
+	double processDryDelay(uint32_t channel, double xn)
+	{
+		if (tankLag_mSec == 0.0)
+			return xn;
+		dryDelay[channel].writeDelay(xn);
+		return dryDelay_mSec > 0.0 ? dryDelay[channel].readDelayAtTime_mSec(dryDelay_mSec) : xn;
+	}
+
+	uint32_t decimationPhase = 0;									///< host samples collected for the next tank sample
+	HalfBandFilter tankDecimator[2][2];								///< [channel][stage], stage [0] into the tank, [1] outer stage for 4x
+	HalfBandFilter tankInterpolator[kMaxTankOutputs][2];			///< [tank output][stage], stages as for tankDecimator
+	double decimatorInput[2][kMaxTankDecimationRatio] = { { 0.0 } };	///< host rate input, one tank sample's worth
+	double interpolatedOutput[kMaxTankOutputs][kMaxTankDecimationRatio] = { { 0.0 } };	///< host rate output of the last tank sample
+
+	/** sub-block kernel; SampleType is float or double, all internal math is double */
+	template <typename SampleType>
+	void processPlateBlock(SampleType** inputs, SampleType** outputs, bool stereoIn, uint32_t startFrame, uint32_t numFrames)
+	{
+		// --- plate at the host rate with settled parameters: diffuse a pass at a time
+		while (numFrames > 0 && canProcessDiffuserBlock())
+		{
+			uint32_t passFrames = numFrames < kDiffuserBlockSize ? numFrames : kDiffuserBlockSize;
+			processDiffuserBlock<SampleType>(inputs, outputs, stereoIn, startFrame, passFrames);
+			startFrame += passFrames;
+			numFrames -= passFrames;
+		}
+
+		SampleType* inL = inputs[0];
+		SampleType* inR = stereoIn ? inputs[1] : inputs[0];
+		SampleType* outL = outputs[0];
+		SampleType* outR = outputs[1];
+
+		for (uint32_t frame = startFrame; frame < startFrame + numFrames; frame++)
+		{
+			if (doSampleAccurateParameterUpdates())
+				UpdateParameters();
+
+			double L = inL[frame];
+			double R = inR[frame];
+			double yn[kMaxTankOutputs];
+			processPlate(L, R, yn);
+
+			double wet = (wet_mix / 100);
+			double dry = (1 - wet_mix / 100);
+			outL[frame] = (SampleType)(yn[0] * wet + processDryDelay(0, L) * dry);
+			outR[frame] = (SampleType)(yn[1] * wet + processDryDelay(1, R) * dry);
+		}
+	}
+
+	/** surround sub-block kernel: any input layout (see setPlateChannelLayout( )), one tank, a tap set per output */
+	template <typename SampleType>
+	void processSurroundBlock(SampleType** inputs, SampleType** outputs, uint32_t startFrame, uint32_t numFrames)
+	{
+		double input[kMaxPlateChannels];
+		double output[kMaxPlateChannels];
+		for (uint32_t frame = startFrame; frame < startFrame + numFrames; frame++)
+		{
+			if (doSampleAccurateParameterUpdates())
+				UpdateParameters();
+
+			for (uint32_t i = 0; i < numPlateInputChannels; i++)
+				input[i] = inputs[i][frame];
+
+			processSurroundFrame(input, output);
+
+			for (uint32_t i = 0; i < numPlateOutputChannels; i++)
+				outputs[i][frame] = (SampleType)output[i];
+		}
+	}
+
+	/** the diffuser block path only runs the plate engine at the host rate with stereo outputs, and needs bound variables
+	    that cannot change before the end of the sub-block; the mix may ramp, it is read from its smoothing ramp */
+	bool canProcessDiffuserBlock()
+	{
+		return !fdnEngineActive && !tankSwitchPending && numTankOutputs == 2 && oversamplingRatio == 1 && decimationRatio == 1 &&
+			parameterUpdatesSettled(controlID::wet_mix);
+	}
+
+	/** block path for processPlateBlock( ): pre-delay and input LPF per sample, the diffusers over the whole pass
+	    (InputDiffuser::processAudioBlock( ), one per lane for the true stereo engine), then the tank and the mix
+	    per sample; same output as the frame path */
+	template <typename SampleType>
+	void processDiffuserBlock(SampleType** inputs, SampleType** outputs, bool stereoIn, uint32_t startFrame, uint32_t numFrames)
+	{
+		SampleType* inL = inputs[0];
+		SampleType* inR = stereoIn ? inputs[1] : inputs[0];
+		SampleType* outL = outputs[0];
+		SampleType* outR = outputs[1];
+
+		for (uint32_t i = 0; i < numFrames; i++)
+		{
+			// --- keeps the smoothers' timebase; only the mix can move, and UpdateParameters( ) does not use it
+			doSampleAccurateParameterUpdates();
+			const double* mixRamp = getSmoothingRamp(controlID::wet_mix);
+			blockMix[i] = mixRamp ? mixRamp[getSmoothingRampFrame()] : wet_mix;
+
+			double L = inL[startFrame + i];
+			double R = inR[startFrame + i];
+			if (trueStereoEngineActive)
+			{
+				double xn[NUM_STEREO_LANES] = { L, R };
+				blockTankInput[i] = fmax(fabs(L), fabs(R));
+				stereoPreDelay.processAudioLanes(xn, xn);
+				stereoLPF[0].processAudioLanes(xn, xn);
+				diffuserBlock[0][i] = xn[0];
+				diffuserBlock[1][i] = xn[1];
+			}
+			else
+			{
+				double xn = stereoIn ? (L + R) * 0.5 : L;
+				blockTankInput[i] = xn;
+				diffuserBlock[0][i] = LPF[0].processAudioSample(preDelay.processAudioSample(xn));
+			}
+		}
+
+		tankFlushed = false;
+		inputDiffuser.processAudioBlock(diffuserBlock[0], numFrames);
+		if (trueStereoEngineActive)
+			rightInputDiffuser.processAudioBlock(diffuserBlock[1], numFrames);
+
+		for (uint32_t i = 0; i < numFrames; i++)
+		{
+			double yn[kMaxTankOutputs];
+			if (trueStereoEngineActive)
+			{
+				double diffused[NUM_STEREO_LANES] = { diffuserBlock[0][i], diffuserBlock[1][i] };
+				processTrueStereoTankLoop(diffused, yn);
+			}
+			else
+				processTankLoop(diffuserBlock[0][i], yn);
+			trackTankSilence(blockTankInput[i], yn[0], yn[1]);
+
+			uint32_t frame = startFrame + i;
+			double L = inL[frame];
+			double R = inR[frame];
+			double wet = (blockMix[i] / 100);
+			double dry = (1 - blockMix[i] / 100);
+			outL[frame] = (SampleType)(yn[0] * wet + L * dry);
+			outR[frame] = (SampleType)(yn[1] * wet + R * dry);
+		}
+	}
+	double diffuserBlock[NUM_STEREO_LANES][kDiffuserBlockSize] = { { 0.0 } };	///< one pass of the diffuser input per lane, processed in place
+	double blockTankInput[kDiffuserBlockSize] = { 0.0 };	///< the matching tank inputs (largest lane), for the silence detector
+	double blockMix[kDiffuserBlockSize] = { 0.0 };			///< the matching Dry/Wet values, from the wet_mix smoothing ramp
+
+	// --- engine switches: fade the old tank out, flush it a buffer at a time, then start the new engine
+	void requestTankSwitch(bool useFDN, bool useTrueStereo);
+	void completeTankSwitch();
+	bool tankSwitchPending = false;			///< a new engine is waiting for the fade-out and the tank flush
+	bool pendingFDNEngine = false;			///< fdnEngineActive once the switch completes
+	bool pendingTrueStereoEngine = false;	///< trueStereoEngineActive once the switch completes
+	uint32_t tankFadeSamples = 0;			///< host samples left in the fade-out; 0 while the muted tank is flushed
+	uint32_t tankFadeLength = 1;			///< fade-out length in host samples
+	bool tankFlushed = true;				///< nothing has entered the tank since reset( ) or the last complete flush
+
+	// --- silence detection and tail-aware sleep
+	bool inputIsSilent(ProcessBufferInfo& processBufferInfo);
+	void trackTankSilence(double xn, double yL, double yR);
+	bool flushNextTankObject();
+	double getDiffuserTime_mSec();
+	double getTankLoopTime_mSec();
+	double calculateTailTime_mSec();
+	bool tankAsleep = false;				///< true when the tail has decayed; frame processing is skipped
+	uint32_t quietSampleCount = 0;			///< consecutive samples with input and tank below threshold
+	uint32_t samplesToSleep = 0;			///< quiet samples required before sleeping (longest signal path)
+	uint32_t flushIndex = 0;				///< next object to flush after going to sleep
+
 
 	// --- END USER VARIABLES AND FUNCTIONS -------------------------------------- //
 
@@ -145,6 +460,11 @@ private:
 	double mod_rate = 0.0;
 	double mod_dpeth = 0.0;
 	double predelay_time = 0.0;
+	double cross_feed = 0.0;
+
+	// --- Discrete Plugin Variables 
+	int engine = 0;
+	enum class engineEnum { Plate,FDN_8,FDN_16,FDN_32,True_Stereo };	// to compare: if(compareEnumToInt(engineEnum::Plate, engine)) etc... 
 
 
 	// **--0x1A7F--**
@@ -230,14 +230,15 @@ const float GUI_METER_MIN_DB = -60.f;				///< min GUI value in dB
 \brief
 Use this strongly typed enum to easily set the smoothing type
 
-- enum class smoothingMethod { kLinearSmoother, kLPFSmoother };
+- enum class smoothingMethod { kLinearSmoother, kLPFSmoother, kMultiplicativeSmoother };
+- kMultiplicativeSmoother (constant ratio per sample, for frequency-like parameters) is only supported by SmootherBank; ParamSmoother treats it as linear
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
 \date Date : 2018 / 09 / 7
 */
-enum class smoothingMethod { kLinearSmoother, kLPFSmoother };
+enum class smoothingMethod { kLinearSmoother, kLPFSmoother, kMultiplicativeSmoother };
 
 /**
 \enum taper
@@ -422,4 +423,428 @@ private:
 };
 
 
+// --- largest controlID covered by PluginBase's dense controlID->index table; sparser IDs fall back to the map
+const uint32_t MAX_CONTROL_ID_TABLE_SIZE = 65536;
+
+// --- SmootherBank renders ramps in chunks of this many samples
+const uint32_t SMOOTHER_BLOCK_SIZE = 64;
+
+/**
+\class SmootherBank
+\ingroup ASPiK-Core
+\brief
+The SmootherBank object performs parameter smoothing for a whole set of parameters at once. All state is
+stored in structure-of-arrays form and ramps are rendered SMOOTHER_BLOCK_SIZE samples at a time into
+per-smoother buffers that the DSP code can read directly.
+
+- linear: constant step of (max - min)/smoothing-time, same as ParamSmoother
+- one-pole (kLPFSmoother): same recursion and coefficient as ParamSmoother
+- multiplicative: constant ratio per sample, reaches the target in the smoothing time; falls back to linear
+  if the start and target values are not both positive
+- a smoother goes idle once its value, stored as float, equals the target
+- rampTo( ) runs a linear segment of a given length regardless of the smoothing type; this is how host automation
+  points are turned into per-sample ramps (see PluginBase::applySampleAccurateAutomation( ))
+
+Operation:
+- init( ) allocates (not on the audio thread); setSampleRate( ) and configure( ) do not allocate
+- setTarget( ) then processBlock( ) once per chunk; getRamp( ) returns that chunk's per-sample values
+- a target that moves part way through a chunk can restart its smoother there (setTarget( ) with a chunk position)
+*/
+class SmootherBank
+{
+public:
+	SmootherBank() {}
+	~SmootherBank() { destroy(); }
+
+	/** allocate storage for a number of smoothers; do NOT call from the audio thread */
+	void init(uint32_t _numSmoothers)
+	{
+		destroy();
+		numSmoothers = _numSmoothers;
+		if (numSmoothers == 0)
+			return;
+
+		current = new double[numSmoothers];
+		target = new double[numSmoothers];
+		step = new double[numSmoothers];
+		coeffA = new double[numSmoothers];
+		smoothingTimeMsec = new double[numSmoothers];
+		minValue = new double[numSmoothers];
+		maxValue = new double[numSmoothers];
+		type = new smoothingMethod[numSmoothers];
+		enabled = new bool[numSmoothers];
+		active = new bool[numSmoothers];
+		ramping = new bool[numSmoothers];
+		segment = new bool[numSmoothers];
+		segmentStep = new double[numSmoothers];
+		ramp = new double[numSmoothers * SMOOTHER_BLOCK_SIZE];
+
+		for (uint32_t i = 0; i < numSmoothers; i++)
+		{
+			current[i] = target[i] = step[i] = coeffA[i] = 0.0;
+			smoothingTimeMsec[i] = 100.0;
+			minValue[i] = 0.0;
+			maxValue[i] = 1.0;
+			type[i] = smoothingMethod::kLPFSmoother;
+			enabled[i] = false;
+			active[i] = false;
+			ramping[i] = false;
+			segment[i] = false;
+			segmentStep[i] = 0.0;
+		}
+		for (uint32_t i = 0; i < numSmoothers * SMOOTHER_BLOCK_SIZE; i++)
+			ramp[i] = 0.0;
+	}
+
+	/**
+	\brief set up one smoother; safe on the audio thread
+
+	\param index the smoother
+	\param _enabled false = the value jumps to its target
+	\param _type ramp type
+	\param _smoothingTimeMsec time to traverse the min-max range (linear, one-pole) or to reach the target (multiplicative)
+	\param _minValue minimum control value
+	\param _maxValue maximum control value
+	\param initValue starting value; the smoother is idle at this value
+	*/
+	void configure(uint32_t index, bool _enabled, smoothingMethod _type, double _smoothingTimeMsec, double _minValue, double _maxValue, double initValue)
+	{
+		if (index >= numSmoothers) return;
+		enabled[index] = _enabled;
+		type[index] = _type;
+		smoothingTimeMsec[index] = _smoothingTimeMsec;
+		minValue[index] = _minValue;
+		maxValue[index] = _maxValue;
+		current[index] = initValue;
+		target[index] = initValue;
+		active[index] = false;
+		segment[index] = false;
+		updateCoefficient(index);
+		fillRamp(index, initValue);
+	}
+
+	/** recalculate coefficients for a new sample rate; safe on the audio thread */
+	void setSampleRate(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+		for (uint32_t i = 0; i < numSmoothers; i++)
+			updateCoefficient(i);
+	}
+
+	/**
+	\brief turn smoothing on or off for one smoother (e.g. during a state load); when off, the value jumps to its target
+
+	\param index the smoother
+	\param _enabled the flag
+	*/
+	void setEnabled(uint32_t index, bool _enabled) { if (index < numSmoothers) enabled[index] = _enabled; }
+
+	/**
+	\brief set a new destination; a no-op if the target has not changed
+
+	\param index the smoother
+	\param newTarget the destination value
+	*/
+	void setTarget(uint32_t index, double newTarget)
+	{
+		if (index >= numSmoothers || newTarget == target[index])
+			return;
+
+		target[index] = newTarget;
+		segment[index] = false;
+		if (!enabled[index])
+		{
+			jumpTo(index, newTarget);
+			return;
+		}
+
+		active[index] = (float)current[index] != (float)newTarget;
+		if (type[index] == smoothingMethod::kMultiplicativeSmoother)
+		{
+			double numSamples = fmax(1.0, smoothingTimeMsec[index] * 0.001 * sampleRate);
+			step[index] = current[index] > 0.0 && newTarget > 0.0 ? pow(newTarget / current[index], 1.0 / numSamples) : 0.0;
+		}
+	}
+
+	/**
+	\brief set the value immediately with no ramp (e.g. sample accurate automation)
+
+	\param index the smoother
+	\param value the new value
+	*/
+	void jumpTo(uint32_t index, double value)
+	{
+		if (index >= numSmoothers) return;
+		current[index] = target[index] = value;
+		active[index] = false;
+		ramping[index] = false;
+		segment[index] = false;
+	}
+
+	/**
+	\brief start a linear segment that reaches newTarget after numSamples samples, whatever the smoothing type;
+		   the rest of the current chunk is re-rendered so the segment can start mid-chunk
+
+	\param index the smoother
+	\param startValue the value just before the segment (the last value handed out)
+	\param newTarget the destination value
+	\param numSamples segment length; newTarget is the numSamples-th value
+	\param fromFrame first chunk position of the segment (the next getRamp( ) index to be read); SMOOTHER_BLOCK_SIZE
+		   means the segment starts with the next chunk
+	*/
+	void rampTo(uint32_t index, double startValue, double newTarget, uint32_t numSamples, uint32_t fromFrame)
+	{
+		if (index >= numSmoothers) return;
+
+		target[index] = newTarget;
+		current[index] = startValue;
+		segmentStep[index] = (newTarget - startValue) / (double)(numSamples > 0 ? numSamples : 1);
+		segment[index] = true;
+		active[index] = (float)startValue != (float)newTarget;
+
+		if (fromFrame >= SMOOTHER_BLOCK_SIZE)
+		{
+			if (!active[index])
+			{
+				current[index] = newTarget;
+				segment[index] = false;
+			}
+			return;
+		}
+
+		renderSegment(index, fromFrame);
+		ramping[index] = true;
+	}
+
+	/**
+	\brief move the target of one smoother part way through the current chunk; the smoother restarts from the value
+		   handed out last and the rest of the chunk is re-rendered, so a new target does not wait for the next chunk
+
+	\param index the smoother
+	\param newTarget the destination value
+	\param fromFrame first chunk position to re-render (the next getRamp( ) index to be read); 0 or SMOOTHER_BLOCK_SIZE
+		   means the target is picked up by the next processBlock( ), as with setTarget( )
+	*/
+	void setTarget(uint32_t index, double newTarget, uint32_t fromFrame)
+	{
+		if (index >= numSmoothers || newTarget == target[index])
+			return;
+
+		if (fromFrame == 0 || fromFrame >= SMOOTHER_BLOCK_SIZE)
+		{
+			setTarget(index, newTarget);
+			return;
+		}
+
+		bool rampingInChunk = ramping[index];
+		current[index] = ramp[index * SMOOTHER_BLOCK_SIZE + fromFrame - 1];
+		setTarget(index, newTarget);
+		renderChunk(index, fromFrame);
+		ramping[index] = ramping[index] || rampingInChunk;
+	}
+
+	/** render the next SMOOTHER_BLOCK_SIZE samples for every active smoother */
+	void processBlock()
+	{
+		for (uint32_t i = 0; i < numSmoothers; i++)
+			renderChunk(i, 0);
+	}
+
+	/**
+	\brief per-sample values for the chunk rendered by the last processBlock( )
+
+	\param index the smoother
+	\return pointer to SMOOTHER_BLOCK_SIZE values
+	*/
+	const double* getRamp(uint32_t index) { return ramp + index * SMOOTHER_BLOCK_SIZE; }
+
+	/** true if the chunk rendered by the last processBlock( ) is a ramp (the values change) */
+	bool isRamping(uint32_t index) { return ramping[index]; }
+
+	/** true if the smoother has not reached its target yet */
+	bool isActive(uint32_t index) { return active[index]; }
+
+	/** current value (end of the last rendered chunk) */
+	double getCurrentValue(uint32_t index) { return current[index]; }
+
+	/** number of smoothers */
+	uint32_t getNumSmoothers() { return numSmoothers; }
+
+private:
+	void updateCoefficient(uint32_t i)
+	{
+		double samples = fmax(1.0, smoothingTimeMsec[i] * 0.001 * sampleRate);
+		coeffA[i] = exp(-kTwoPi / samples);
+
+		// --- step[] is the linear increment, or the ratio for multiplicative ramps (set in setTarget)
+		if (type[i] != smoothingMethod::kMultiplicativeSmoother)
+			step[i] = (maxValue[i] - minValue[i]) / samples;
+	}
+
+	double linearStep(uint32_t i)
+	{
+		return fabs(maxValue[i] - minValue[i]) / fmax(1.0, smoothingTimeMsec[i] * 0.001 * sampleRate);
+	}
+
+	// --- render chunk positions fromFrame...end for one smoother, starting from current[i]; updates current[i]
+	void renderChunk(uint32_t i, uint32_t fromFrame)
+	{
+		double* out = ramp + i * SMOOTHER_BLOCK_SIZE;
+		ramping[i] = active[i];
+		if (!active[i])
+		{
+			// --- idle smoothers only need their buffer refreshed once (ramps are monotonic, so check both ends)
+			if (out[fromFrame] != current[i] || out[SMOOTHER_BLOCK_SIZE - 1] != current[i])
+				fillRamp(i, current[i], fromFrame);
+			return;
+		}
+
+		const double z0 = current[i];
+		const double t = target[i];
+
+		if (segment[i])
+		{
+			// --- automation segment: linear with its own step
+			renderSegment(i, fromFrame);
+			return;
+		}
+
+		if (type[i] == smoothingMethod::kLPFSmoother)
+		{
+			// --- one-pole: z = t*b + z*a
+			const double a = coeffA[i];
+			const double b = 1.0 - a;
+			double z = z0;
+			for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+			{
+				z = t*b + z*a;
+				out[n] = z;
+			}
+		}
+		else if (type[i] == smoothingMethod::kMultiplicativeSmoother && step[i] > 0.0)
+		{
+			// --- constant ratio, clamped at the target
+			const double r = step[i];
+			double z = z0;
+			if (r > 1.0)
+			{
+				for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+				{
+					z *= r;
+					out[n] = z > t ? t : z;
+				}
+			}
+			else
+			{
+				for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+				{
+					z *= r;
+					out[n] = z < t ? t : z;
+				}
+			}
+		}
+		else
+		{
+			// --- linear: closed form, no loop-carried dependency so this loop vectorizes
+			const double inc = step[i] > 0.0 ? step[i] : linearStep(i);
+			if (t > z0)
+			{
+				for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+				{
+					double v = z0 + inc*(double)(n - fromFrame + 1);
+					out[n] = v > t ? t : v;
+				}
+			}
+			else
+			{
+				for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+				{
+					double v = z0 - inc*(double)(n - fromFrame + 1);
+					out[n] = v < t ? t : v;
+				}
+			}
+		}
+
+		current[i] = out[SMOOTHER_BLOCK_SIZE - 1];
+		if ((float)current[i] == (float)t)
+		{
+			current[i] = t;
+			active[i] = false;
+		}
+	}
+
+	// --- render a linear segment from current[i] into chunk positions fromFrame...end; updates current[i]
+	void renderSegment(uint32_t i, uint32_t fromFrame)
+	{
+		double* out = ramp + i * SMOOTHER_BLOCK_SIZE;
+		const double z0 = current[i];
+		const double t = target[i];
+		const double inc = segmentStep[i];
+
+		for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+		{
+			double v = z0 + inc*(double)(n - fromFrame + 1);
+			out[n] = (inc > 0.0 && v > t) || (inc < 0.0 && v < t) ? t : v;
+		}
+
+		current[i] = out[SMOOTHER_BLOCK_SIZE - 1];
+		if ((float)current[i] == (float)t)
+		{
+			current[i] = t;
+			active[i] = false;
+			segment[i] = false;
+		}
+	}
+
+	void fillRamp(uint32_t i, double value, uint32_t fromFrame = 0)
+	{
+		double* out = ramp + i * SMOOTHER_BLOCK_SIZE;
+		for (uint32_t n = fromFrame; n < SMOOTHER_BLOCK_SIZE; n++)
+			out[n] = value;
+	}
+
+	void destroy()
+	{
+		delete[] current; current = nullptr;
+		delete[] target; target = nullptr;
+		delete[] step; step = nullptr;
+		delete[] coeffA; coeffA = nullptr;
+		delete[] smoothingTimeMsec; smoothingTimeMsec = nullptr;
+		delete[] minValue; minValue = nullptr;
+		delete[] maxValue; maxValue = nullptr;
+		delete[] type; type = nullptr;
+		delete[] enabled; enabled = nullptr;
+		delete[] active; active = nullptr;
+		delete[] ramping; ramping = nullptr;
+		delete[] segment; segment = nullptr;
+		delete[] segmentStep; segmentStep = nullptr;
+		delete[] ramp; ramp = nullptr;
+		numSmoothers = 0;
+	}
+
+	// --- no copies; owns raw arrays
+	SmootherBank(const SmootherBank&) = delete;
+	SmootherBank& operator=(const SmootherBank&) = delete;
+
+	uint32_t numSmoothers = 0;				///< number of smoothers
+	double sampleRate = 44100.0;			///< fs
+
+	// --- structure-of-arrays state, one entry per smoother
+	double* current = nullptr;				///< value at the end of the last chunk
+	double* target = nullptr;				///< destination
+	double* step = nullptr;					///< linear increment or multiplicative ratio
+	double* coeffA = nullptr;				///< one-pole coefficient
+	double* smoothingTimeMsec = nullptr;	///< smoothing time
+	double* minValue = nullptr;				///< min extrema
+	double* maxValue = nullptr;				///< max extrema
+	smoothingMethod* type = nullptr;		///< ramp type
+	bool* enabled = nullptr;				///< smoothing on/off
+	bool* active = nullptr;					///< target not yet reached
+	bool* ramping = nullptr;				///< last rendered chunk is a ramp
+	bool* segment = nullptr;				///< running a linear automation segment (rampTo( ))
+	double* segmentStep = nullptr;			///< per-sample increment of the automation segment
+	double* ramp = nullptr;					///< [numSmoothers][SMOOTHER_BLOCK_SIZE] rendered values
+};
+
+
 #endif
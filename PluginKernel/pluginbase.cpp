@@ -22,10 +22,10 @@ Operation:
 */
 PluginBase::PluginBase()
 {
-    memset(&inputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
-    memset(&outputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
-    memset(&auxInputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
-    memset(&auxOutputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
+    memset(&inputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
+    memset(&outputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
+    memset(&auxInputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
+    memset(&auxOutputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
 
     pluginHostConnector = nullptr;
 }
@@ -58,6 +58,64 @@ PluginBase::~PluginBase()
 	delete [] pluginParameterArray;
 	delete [] smoothablePluginParameters;
 	delete [] outboundPluginParameters;
+	delete [] parameterSnapshot;
+	delete [] parameterTargetSnapshot;
+	delete [] parameterSnapshotScratch;
+	delete [] parameterTargetSnapshotScratch;
+	delete [] parameterSnapshotDirty;
+	delete [] smoothableSnapshotIndex;
+	delete [] guiParameterChangeFlags;
+	delete [] controlIDToIndexTable;
+	delete [] automatedParameterIndex;
+	delete [] automationPointIndex;
+	delete [] automationSegmentOffset;
+	delete [] parameterSmootherIndex;
+}
+
+/**
+\brief GUI timer: get the control IDs of parameters that changed since the last call and clear their flags
+
+NOTES:
+- lock-free; each flag word is swapped with zero, so a change that lands during the call is kept for the next one
+- a closed or idle GUI does no work here; writers only pay one atomic OR when a value actually changes
+
+\param changedControlIDs vector to fill (cleared first)
+
+\return true (the change flags are always available once the parameter list is initialized)
+*/
+bool PluginBase::getGUIParameterChanges(std::vector<int32_t>& changedControlIDs)
+{
+	changedControlIDs.clear();
+	if (!guiParameterChangeFlags)
+		return false;
+
+	for (uint32_t word = 0; word < numGUIParameterChangeWords; word++)
+	{
+		uint64_t flags = guiParameterChangeFlags[word].exchange(0, std::memory_order_acquire);
+		for (uint32_t bit = 0; flags != 0 && bit < 64; bit++)
+		{
+			if (!(flags & ((uint64_t)1 << bit)))
+				continue;
+
+			flags &= ~((uint64_t)1 << bit);
+			uint32_t index = word * 64 + bit;
+			if (index < numPluginParameters)
+				changedControlIDs.push_back(pluginParameterArray[index]->getControlID());
+		}
+	}
+	return true;
+}
+
+/**
+\brief flag a parameter as changed for the GUI regardless of its value
+
+\param controlID the control ID of the parameter
+*/
+void PluginBase::markGUIParameterChanged(int32_t controlID)
+{
+	PluginParameter* piParam = getPluginParameterByControlID(controlID);
+	if (piParam)
+		piParam->notifyGUIChange();
 }
 
 /**
@@ -77,6 +135,12 @@ bool PluginBase::reset(ResetInfo& resetInfo)
 			piParam->updateSampleRate(resetInfo.sampleRate);
 	}
 
+	smootherBank.setSampleRate(resetInfo.sampleRate);
+	smootherFrame = SMOOTHER_BLOCK_SIZE - 1;
+
+	// --- the derived class may have reset its DSP objects; have them re-cooked on the first frame
+	pendingParameterUpdate = true;
+
 	return true;
 }
 
@@ -98,11 +162,19 @@ bool PluginBase::initialize(PluginInfo& _pluginInfo)
 \brief initialize object for a new run of audio; called just before audio streams
 
 Operation:
-- iterate through parameters and copy their values into the bound variables you set up
+- pick up the parameter snapshot; if nothing has been written since the last buffer, there is nothing to do
+- iterate through the changed parameters and copy their snapshot values into the bound variables you set up; the
+  snapshot is one consistent set, so a write that lands mid-loop waits for the next buffer instead of mixing in
 - then, call the postUpdatePluginParameter method to do any post-update cooking required to use the variable for processing
+- NOTE: smoothed parameters update their bound variables per-sample in doSampleAccurateParameterUpdates()
 */
 void PluginBase::syncInBoundVariables()
 {
+	if (!updateParameterSnapshot())
+		return;
+
+	pendingParameterUpdate = true;
+
 	ParameterUpdateInfo info;
 	info.bufferProcUpdate = true;
 	info.boundVariableUpdate = true;
@@ -110,13 +182,70 @@ void PluginBase::syncInBoundVariables()
 	// --- rip through and synch em
 	for (unsigned int i = 0; i < numPluginParameters; i++)
 	{
-		if (pluginParameterArray[i] && pluginParameterArray[i]->updateInBoundVariable())
+		if (parameterSnapshotDirty[i] && pluginParameterArray[i] && pluginParameterArray[i]->updateInBoundVariable(parameterSnapshot[i]))
 		{
-			postUpdatePluginParameter(pluginParameterArray[i]->getControlID(), pluginParameterArray[i]->getControlValue(), info);
+			postUpdatePluginParameter(pluginParameterArray[i]->getControlID(), parameterSnapshot[i], info);
 		}
 	}
 }
 
+/**
+\brief copy every parameter into the contiguous snapshot arrays; audio thread only
+
+Operation:
+- writers (GUI, host, preset loads) bump parameterChangeCounter after each write; if it has not moved, the snapshot is current
+- while a beginParameterBatch()/endParameterBatch() pair is open the old snapshot is kept so the audio thread never sees a half-loaded preset
+- values are copied into scratch arrays first; if a writer raced the copy (counter moved) the scratch copy is discarded and the
+  previous snapshot stays in use until a later buffer gets a clean copy; the copy takes microseconds, so even continuous GUI
+  movement only rarely lands inside it
+- parameterSnapshotDirty[] flags the parameters whose control value actually changed
+- pendingSmootherTargets flags moved smoothing targets for doSampleAccurateParameterUpdates( )
+
+\return true if the snapshot changed, false otherwise
+*/
+bool PluginBase::updateParameterSnapshot()
+{
+	if (!parameterSnapshot)
+		return false;
+
+	uint32_t version = parameterChangeCounter.load(std::memory_order_acquire);
+	if (parameterSnapshotValid && version == parameterSnapshotVersion)
+		return false;
+
+	if (parameterBatchDepth.load(std::memory_order_acquire) > 0)
+		return false;
+
+	for (uint32_t i = 0; i < numPluginParameters; i++)
+	{
+		parameterSnapshotScratch[i] = pluginParameterArray[i]->getControlValue();
+		parameterTargetSnapshotScratch[i] = pluginParameterArray[i]->getTargetControlValue();
+	}
+
+	// --- seqlock validation
+	std::atomic_thread_fence(std::memory_order_acquire);
+	bool consistent = parameterChangeCounter.load(std::memory_order_relaxed) == version &&
+					  parameterBatchDepth.load(std::memory_order_relaxed) == 0;
+
+	if (!consistent)
+		return false;
+
+	// --- commit
+	bool changed = false;
+	for (uint32_t i = 0; i < numPluginParameters; i++)
+	{
+		parameterSnapshotDirty[i] = !parameterSnapshotValid || parameterSnapshotScratch[i] != parameterSnapshot[i];
+		changed |= parameterSnapshotDirty[i];
+		pendingSmootherTargets |= parameterTargetSnapshotScratch[i] != parameterTargetSnapshot[i];
+		parameterSnapshot[i] = parameterSnapshotScratch[i];
+		parameterTargetSnapshot[i] = parameterTargetSnapshotScratch[i];
+	}
+
+	parameterSnapshotVersion = version;
+	parameterSnapshotValid = true;
+
+	return changed;
+}
+
 /**
 \brief THE buffer processing function.
 
@@ -124,8 +253,15 @@ Operation:
 - break channel buffers into frames (one sample from each channel, in and out)
 - call the pre-processing function on derived class to allow it to prepare for the audio buffer's arrival
 - call the frame processing function that the derived class MUST implement repeatedly until the buffer is processed
+- MIDI events and VST3 sample accurate automation points are collected up front and split the buffer into sub-blocks;
+  events fire and automation ramp segments start at the start of each sub-block, so the frames in between run with no
+  event polling; sub-blocks are at least getVST3SampleAccuracyGranularity( ) frames long (events inside that window fire at its start)
+- MIDI queues that cannot report their event offsets (see IMidiEventQueue::canScheduleEvents( )) are fired once per frame
 - call the post-processing function on derived class to allow it to do any stuff that requires the buffer to be processed first
-- NOTE: if you want the derived class to process buffers instead of frames, override and implement THIS function in the derived class
+- pre-processing, the frame loop and post-processing are timed by processTimer (see getProcessTimingInfo())
+- flush-to-zero/denormals-are-zero is enabled for the duration of the call (see ScopedDenormalGuard), so DSP objects do not need per-sample underflow checks
+- NOTE: if you want the derived class to process buffers instead of frames, override and implement THIS function in the derived class; place a ScopedDenormalGuard at the top of your override
+- test builds (ENABLE_RT_SAFETY_WATCHDOG): any heap allocation or mutex lock made while in here is reported, see ScopedRealTimeSection
 
 \param processBufferInfo - a structure of information about the current buffer to process; includes information from host (BPM, etc...)
 
@@ -133,10 +269,19 @@ Operation:
 */
 bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 {
-	memset(&inputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
-	memset(&outputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
-	memset(&auxInputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
-	memset(&auxOutputFrame, 0, sizeof(float)*MAX_CHANNEL_COUNT);
+	// --- FTZ/DAZ for the entire DSP graph; restored when we leave this scope
+	ScopedDenormalGuard denormalGuard;
+
+	// --- test builds: flag heap and lock calls made from here on
+	ScopedRealTimeSection realTimeSection;
+
+	// --- CPU instrumentation; see getProcessTimingInfo( )
+	processTimer.beginBlock(processBufferInfo.numFramesToProcess, audioProcDescriptor.sampleRate);
+
+	memset(&inputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
+	memset(&outputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
+	memset(&auxInputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
+	memset(&auxOutputFrame, 0, sizeof(double)*MAX_CHANNEL_COUNT);
 
 	double sampleInterval = 1.0 / audioProcDescriptor.sampleRate;
 
@@ -162,41 +307,69 @@ bool PluginBase::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
 
 		// --- sync internal bound variables
 		preProcessAudioBuffers(processBufferInfo);
-
-		// --- build frames, one sample from each channel
-		for (uint32_t frame = 0; frame<processBufferInfo.numFramesToProcess; frame++)
+		processTimer.endStage(kPreProcessStage);
+
+		// --- sub-block scheduler setup
+		uint32_t numFrames = processBufferInfo.numFramesToProcess;
+		uint32_t granularity = getVST3SampleAccuracyGranularity() > 0 ? getVST3SampleAccuracyGranularity() : 1;
+		IMidiEventQueue* midiQueue = processBufferInfo.midiEventQueue;
+		bool scheduleMidi = midiQueue && midiQueue->canScheduleEvents();
+		bool pollMidi = midiQueue && !scheduleMidi;
+		beginSampleAccurateAutomation(numFrames);
+
+		uint32_t frame = 0;
+		while (frame < numFrames)
 		{
-			for (uint32_t i = 0; i<processBufferInfo.numAudioInChannels; i++)
+			// --- automation values at this frame; the next point (or ramp step) ends the sub-block
+			uint32_t subBlockEnd = applySampleAccurateAutomation(frame, numFrames);
+
+			uint32_t eventOffset = 0;
+			if (scheduleMidi && midiQueue->getNextEventOffset(eventOffset) && eventOffset > frame && eventOffset < subBlockEnd)
+				subBlockEnd = eventOffset;
+
+			// --- minimum sub-block length
+			if (subBlockEnd < frame + granularity)
+				subBlockEnd = frame + granularity;
+			if (subBlockEnd > numFrames)
+				subBlockEnd = numFrames;
+
+			// --- fire everything due before the end of the sub-block; each call consumes at least one event,
+			//     the count guards against a queue that does not
+			if (scheduleMidi)
 			{
-				inputFrame[i] = processBufferInfo.inputs[i][frame];
+				uint32_t guard = midiQueue->getEventCount();
+				while (guard-- > 0 && midiQueue->getNextEventOffset(eventOffset) && eventOffset < subBlockEnd)
+					midiQueue->fireMidiEvents(eventOffset);
 			}
 
-			for (uint32_t i = 0; i<processBufferInfo.numAuxAudioInChannels; i++)
+			// --- derived class renders the whole sub-block from the host buffers (no per-frame copies);
+			//     not possible when MIDI has to be polled per frame
+			if (pollMidi == false && processAudioSubBlock(processBufferInfo, frame, subBlockEnd - frame))
 			{
-				auxInputFrame[i] = processBufferInfo.auxInputs[i][frame];
+				info.hostInfo->uAbsoluteFrameBufferIndex += subBlockEnd - frame;
+				info.hostInfo->dAbsoluteFrameBufferTime += (subBlockEnd - frame) * sampleInterval;
+				frame = subBlockEnd;
+				continue;
 			}
 
-			info.currentFrame = frame;
-
-			// -- process the frame of data
-			processAudioFrame(info);
-
-			for (uint32_t i = 0; i<processBufferInfo.numAudioOutChannels; i++)
-			{
-				processBufferInfo.outputs[i][frame] = outputFrame[i];
-			}
-			for (uint32_t i = 0; i<processBufferInfo.numAuxAudioOutChannels; i++)
-			{
-				processBufferInfo.auxOutputs[i][frame] = auxOutputFrame[i];
-			}
-
-			// --- update per-frame
-			info.hostInfo->uAbsoluteFrameBufferIndex += 1;
-			info.hostInfo->dAbsoluteFrameBufferTime += sampleInterval;
+			// --- build frames, one sample from each channel
+			if (processBufferInfo.outputs64)
+				processFrameLoop<double>(info, processBufferInfo.inputs64, processBufferInfo.outputs64, processBufferInfo.auxInputs64,
+										 processBufferInfo.auxOutputs64, processBufferInfo, frame, subBlockEnd, pollMidi, sampleInterval);
+			else
+				processFrameLoop<float>(info, processBufferInfo.inputs, processBufferInfo.outputs, processBufferInfo.auxInputs,
+										processBufferInfo.auxOutputs, processBufferInfo, frame, subBlockEnd, pollMidi, sampleInterval);
+			frame = subBlockEnd;
 		}
 
+		// --- land exactly on the last automation points and let go of the host queues
+		endSampleAccurateAutomation();
+		processTimer.endStage(kFrameLoopStage);
+
 		// --- generally not used
 		postProcessAudioBuffers(processBufferInfo);
+		processTimer.endStage(kPostProcessStage);
+		processTimer.endBlock();
 
 		return true; /// processed
 	}
@@ -232,27 +405,64 @@ bool PluginBase::updateOutBoundVariables()
 
 
 /**
-\brief combines parameter smoothing and VST3 sample accurate updates
+\brief per-sample parameter smoothing
 
 NOTE:
-- beware: this function can eat a lot of CPU if the sample accurate updates trigger complex cooking functions
-- to combat CPU usage, you can set the VST3 sample granularity in initPluginDescriptors() apiSpecificInfo.vst3SampleAccurateGranularity
-- you can also change the parameter smoothing granularity
-- but in either case, the list MUST be iterated; this function is the reason for the old-fashioned C-array of pointers\n
-  as it was found to be faster than any other list method for entire-list iteration (if you have a faster way, let me knmow!)
+- VST3 sample accurate automation is applied by the sub-block scheduler in processAudioBuffers( ) (see applySampleAccurateAutomation( )),
+  so this function no longer polls the host automation queues each sample
+- smoothing runs in the SmootherBank: every SMOOTHER_BLOCK_SIZE samples, all smoothers get their targets from the parameter snapshot
+  (see updateParameterSnapshot()) and render a chunk of ramp values at once; each call here then just reads the next value
+- a snapshot that moves a target part way through a chunk (new buffer) restarts that smoother at the current frame, so the
+  new target is not held back until the next chunk
+- when no smoother is ramping in the current chunk, the parameter list is not iterated at all
 - the parameter is updated with the smoothed value
-- the post-parameter update function is then called (complex cooking functions here will eat the CPU as well)
+- the post-parameter update function is then called (complex cooking functions here will eat the CPU)
+
+\return true if any bound variable changed since the last call (smoothing, automation or a new parameter snapshot), so the
+		caller can skip recalculating its DSP objects otherwise
 */
-void PluginBase::doSampleAccurateParameterUpdates()
+bool PluginBase::doSampleAccurateParameterUpdates()
 {
+	bool updated = pendingParameterUpdate;
+	pendingParameterUpdate = false;
+
 	if (numSmoothablePluginParameters == 0)
-		return;
+		return updated;
 
-	// --- do updates
-	double value = 0;
-	bool vstSAAutomated = false;
-	ParameterUpdateInfo vst3Update(false, true); /// false = this is NOT called from smoothing operation, true: this is a VST sample accurate update
-	vst3Update.isVSTSampleAccurateUpdate = true;
+	// --- render the next chunk of smoothing ramps for all parameters at once
+	if (++smootherFrame >= SMOOTHER_BLOCK_SIZE)
+	{
+		for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+		{
+			smootherBank.setEnabled(i, smoothablePluginParameters[i]->getParameterSmoothing());
+			smootherBank.setTarget(i, parameterTargetSnapshot[smoothableSnapshotIndex[i]]);
+		}
+		smootherBank.processBlock();
+		smootherFrame = 0;
+
+		pendingSmootherTargets = false;
+
+		smoothersRamping = false;
+		for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+			smoothersRamping |= smootherBank.isRamping(i);
+	}
+	else if (pendingSmootherTargets)
+	{
+		// --- new targets mid-chunk: only the moved smoothers re-render, from this frame on
+		for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+		{
+			smootherBank.setEnabled(i, smoothablePluginParameters[i]->getParameterSmoothing());
+			smootherBank.setTarget(i, parameterTargetSnapshot[smoothableSnapshotIndex[i]], smootherFrame);
+		}
+		pendingSmootherTargets = false;
+
+		smoothersRamping = false;
+		for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+			smoothersRamping |= smootherBank.isRamping(i);
+	}
+
+	if (!smoothersRamping)
+		return updated;
 
 	ParameterUpdateInfo paramSmoothUpdate(true, false); /// true = this is called from smoothing operation, false = NOT VST sample accurate update
 	paramSmoothUpdate.isSmoothing = true;
@@ -261,42 +471,267 @@ void PluginBase::doSampleAccurateParameterUpdates()
 	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
 	{
 		PluginParameter* piParam = smoothablePluginParameters[i];
-		if (piParam)
+		if (piParam && smootherBank.isRamping(i))
+		{
+			piParam->setSmoothedControlValue(smootherBank.getRamp(i)[smootherFrame]);
+
+			// --- update bound variable, if there is one
+			if (piParam->updateInBoundVariable())
+			{
+				paramSmoothUpdate.boundVariableUpdate = true;
+			}
+			postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), paramSmoothUpdate);
+			updated = true;
+		}
+	}
+	return updated;
+}
+
+/**
+\brief check that the per-frame parameter updates are quiet, so block based DSP can run a whole sub-block with the
+current bound variables
+
+NOTES:
+- automation points, snapshot syncs and MIDI are only applied at sub-block boundaries, so a settled state holds until the
+  end of the current sub-block
+- a smoother whose target moved is not picked up until the next doSampleAccurateParameterUpdates( ) call, so the targets
+  are compared here as well as the ramping flags
+- the smoother of rampedControlID is left out: the caller reads that parameter from getSmoothingRamp( ) and does not need
+  its DSP objects updated when it changes (doSampleAccurateParameterUpdates( ) then only reports that parameter)
+
+\param rampedControlID control ID of a parameter the caller reads from its ramp, or -1
+
+\return true if doSampleAccurateParameterUpdates( ) will not report a change, other than to rampedControlID, for the rest of the sub-block
+*/
+bool PluginBase::parameterUpdatesSettled(int32_t rampedControlID)
+{
+	if (pendingParameterUpdate)
+		return false;
+
+	int32_t parameterIndex = rampedControlID >= 0 && parameterSmootherIndex ? getPluginParameterIndexByControlID(rampedControlID) : -1;
+	int32_t rampedSmoother = parameterIndex >= 0 ? parameterSmootherIndex[parameterIndex] : -1;
+	if (smoothersRamping && rampedSmoother < 0)
+		return false;
+
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+	{
+		if ((int32_t)i == rampedSmoother)
+			continue;
+		if (smootherBank.isRamping(i) || smootherBank.isActive(i) || smootherBank.getCurrentValue(i) != parameterTargetSnapshot[smoothableSnapshotIndex[i]])
+			return false;
+	}
+	return true;
+}
+
+/**
+\brief sub-block scheduler: collect the parameters that have VST3 sample accurate automation points in this buffer
+
+NOTES:
+- only smoothable (double/float) parameters with sample accurate automation enabled get ramp segments;
+  any other parameter with a queue jumps straight to its last point
+- no allocation; the lane arrays are sized in initPluginParameterArray( )
+
+\param numFrames the buffer length
+*/
+void PluginBase::beginSampleAccurateAutomation(uint32_t numFrames)
+{
+	numAutomatedParameters = 0;
+	if (!automatedParameterIndex)
+		return;
+
+	for (uint32_t i = 0; i < numPluginParameters; i++)
+	{
+		PluginParameter* piParam = pluginParameterArray[i];
+		IParameterUpdateQueue* queue = piParam->getParameterUpdateQueue();
+		if (!queue)
+			continue;
+
+		uint32_t pointCount = queue->getPointCount();
+		uint32_t offset = 0;
+		double value = 0.0;
+
+		if (pointCount == 0)
+			continue;
+
+		if (!wantsVST3SampleAccurateAutomation() || !piParam->getEnableVSTSampleAccurateAutomation() || parameterSmootherIndex[i] < 0)
+		{
+			if (queue->getPoint(pointCount - 1, offset, value))
+				applyAutomationValue(i, value);
+			piParam->setParameterUpdateQueue(nullptr);
+			continue;
+		}
+
+		// --- the first segment ramps from the current value, as in the VST3 spec
+		automatedParameterIndex[numAutomatedParameters] = i;
+		automationPointIndex[numAutomatedParameters] = 0;
+		automationSegmentOffset[numAutomatedParameters] = 0;
+		numAutomatedParameters++;
+	}
+}
+
+/**
+\brief sub-block scheduler: turn the host automation points into linear ramp segments
+
+NOTES:
+- at each automation point the parameter's smoother gets a linear segment to the next point (SmootherBank::rampTo( ));
+  the per-sample values then come out of the smoothing ramps in doSampleAccurateParameterUpdates( ), and DSP code can
+  read them directly with getSmoothingRamp( )
+- the parameter's target (and the snapshot target the smoothers follow) is set to the segment end, so normal
+  parameter smoothing never pulls the value back to an older target
+
+\param frame the first frame of the new sub-block
+\param numFrames the buffer length
+
+\return the frame of the next automation point, or numFrames if there is none
+*/
+uint32_t PluginBase::applySampleAccurateAutomation(uint32_t frame, uint32_t numFrames)
+{
+	uint32_t nextFrame = numFrames;
+
+	for (uint32_t n = 0; n < numAutomatedParameters; n++)
+	{
+		uint32_t parameterIndex = automatedParameterIndex[n];
+		PluginParameter* piParam = pluginParameterArray[parameterIndex];
+		IParameterUpdateQueue* queue = piParam->getParameterUpdateQueue();
+		uint32_t pointCount = queue->getPointCount();
+		uint32_t offset = 0;
+		double value = 0.0;
+
+		// --- move past the points we have reached
+		bool haveNextPoint = false;
+		bool havePassedPoint = false;
+		uint32_t passedOffset = 0;
+		double passedValue = 0.0;
+		while (automationPointIndex[n] < pointCount && queue->getPoint(automationPointIndex[n], offset, value))
 		{
-			// --- VST sample accurate stuff
-			if (wantsVST3SampleAccurateAutomation())
+			if (offset > frame)
 			{
-				// --- if we get here getParameterUpdateQueue() should be non-null
-				//     NOTE you can disable sample accurate automation for each parameter when you set them up if needed
-				if (piParam->getParameterUpdateQueue() && piParam->getEnableVSTSampleAccurateAutomation())
-				{
-					if (piParam->getParameterUpdateQueue()->getNextValue(value))
-					{
-						piParam->setControlValueNormalized(value, false, true); // false = do not apply taper, true = ignore smoothing (not needed here)
-						vstSAAutomated = true;
-
-						// --- now update the bound variable
-						if (piParam->updateInBoundVariable())
-						{
-							vst3Update.boundVariableUpdate = true;
-						}
-						postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
-					}
-				}
+				haveNextPoint = true;
+				break;
 			}
+			havePassedPoint = true;
+			passedOffset = offset;
+			passedValue = value;
+			automationPointIndex[n]++;
+		}
+
+		// --- already heading for this point (a sub-block can end before a point, e.g. at a MIDI event)
+		if (haveNextPoint && automationSegmentOffset[n] == offset)
+		{
+			if (offset < nextFrame)
+				nextFrame = offset;
+			continue;
+		}
 
-			// --- do smoothing, but not if we did a sample accurate automation update!
-			if (!vstSAAutomated && piParam->smoothParameterValue())
+		// --- last point passed (and not merged into an earlier segment): land on it
+		if (!haveNextPoint)
+		{
+			if (automationPointIndex[n] > 0 && automationSegmentOffset[n] != numFrames)
 			{
-				// --- update bound variable, if there is one
-				if (piParam->updateInBoundVariable())
-				{
-					paramSmoothUpdate.boundVariableUpdate = true;
-				}
-				postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), paramSmoothUpdate);
+				if (queue->getPoint(automationPointIndex[n] - 1, offset, value))
+					applyAutomationValue(parameterIndex, value);
+				automationSegmentOffset[n] = numFrames;
 			}
+			continue;
 		}
+
+		// --- new segment, reaching this point's value at its offset; it runs on from the point we just passed, or from
+		//     the value handed out last if there is none (buffer start)
+		double target = piParam->getControlValueWithNormalizedValue(value, false);
+		double startValue = piParam->getControlValue();
+		if (havePassedPoint)
+		{
+			double passedTarget = piParam->getControlValueWithNormalizedValue(passedValue, false);
+			double slope = (target - passedTarget) / (double)(offset - passedOffset);
+			startValue = passedTarget + slope*((double)frame - (double)passedOffset - 1.0);
+		}
+		smootherBank.rampTo(parameterSmootherIndex[parameterIndex], startValue, target, offset - frame + 1, smootherFrame + 1);
+		piParam->setAutomatedControlValue(target);
+		parameterTargetSnapshot[parameterIndex] = target;
+		smoothersRamping = true;
+
+		automationSegmentOffset[n] = offset;
+		if (offset < nextFrame)
+			nextFrame = offset;
 	}
+	return nextFrame;
+}
+
+/**
+\brief sub-block scheduler: set each automated parameter to its last point and detach the host queue, which is only
+	   valid for this buffer
+*/
+void PluginBase::endSampleAccurateAutomation()
+{
+	for (uint32_t n = 0; n < numAutomatedParameters; n++)
+	{
+		PluginParameter* piParam = pluginParameterArray[automatedParameterIndex[n]];
+		IParameterUpdateQueue* queue = piParam->getParameterUpdateQueue();
+		uint32_t offset = 0;
+		double value = 0.0;
+
+		if (queue && queue->getPointCount() > 0 && queue->getPoint(queue->getPointCount() - 1, offset, value))
+			applyAutomationValue(automatedParameterIndex[n], value);
+		piParam->setParameterUpdateQueue(nullptr);
+	}
+	numAutomatedParameters = 0;
+}
+
+/**
+\brief sub-block scheduler: jump to one automation value; the smoother is jumped to the new value (no smoothing on top of
+	   automation) and the bound variable is updated and cooked only if the value actually changed
+
+\param parameterIndex index into pluginParameterArray
+\param normalizedValue the new value, normalized with no taper
+*/
+void PluginBase::applyAutomationValue(uint32_t parameterIndex, double normalizedValue)
+{
+	PluginParameter* piParam = pluginParameterArray[parameterIndex];
+	double oldValue = piParam->getControlValue();
+
+	piParam->setAutomatedControlValue(piParam->getControlValueWithNormalizedValue(normalizedValue, false)); // false = do not apply taper
+	parameterTargetSnapshot[parameterIndex] = piParam->getTargetControlValue();
+	if (parameterSmootherIndex[parameterIndex] >= 0)
+		smootherBank.jumpTo(parameterSmootherIndex[parameterIndex], piParam->getControlValue());
+
+	if (piParam->getControlValue() == oldValue)
+		return;
+
+	ParameterUpdateInfo vst3Update(false, true); /// false = this is NOT called from smoothing operation, true: this is a VST sample accurate update
+	vst3Update.isVSTSampleAccurateUpdate = true;
+
+	// --- now update the bound variable
+	if (piParam->updateInBoundVariable())
+	{
+		vst3Update.boundVariableUpdate = true;
+	}
+	postUpdatePluginParameter(piParam->getControlID(), piParam->getControlValue(), vst3Update);
+	pendingParameterUpdate = true;
+}
+
+/**
+\brief find the smoothing ramp for a parameter; DSP code can read getSmoothingRamp(id)[getSmoothingRampFrame()] or
+	   consume the rest of the chunk directly
+
+NOTES:
+- O(1): dense controlID table, then parameterSmootherIndex
+- idle smoothers' ramps are only refreshed at the next chunk, so nullptr is returned when the parameter is not ramping
+  in this chunk; the bound variable holds the value then
+
+\param controlID the control ID of the parameter
+
+\return pointer to SMOOTHER_BLOCK_SIZE values, or nullptr if the parameter is not smoothable or not ramping
+*/
+const double* PluginBase::getSmoothingRamp(int32_t controlID)
+{
+	int32_t parameterIndex = parameterSmootherIndex ? getPluginParameterIndexByControlID(controlID) : -1;
+	if (parameterIndex < 0)
+		return nullptr;
+
+	int32_t smoother = parameterSmootherIndex[parameterIndex];
+	if (smoother < 0 || !smootherBank.isRamping((uint32_t)smoother))
+		return nullptr;
+	return smootherBank.getRamp((uint32_t)smoother);
 }
 
 /**
@@ -854,6 +1289,112 @@ void PluginBase::initPluginParameterArray()
 		}
 	}
 
+	// --- parameter snapshot; meters are written by the audio thread itself, so they do not bump the change counter
+	delete[] parameterSnapshot;
+	delete[] parameterTargetSnapshot;
+	delete[] parameterSnapshotScratch;
+	delete[] parameterTargetSnapshotScratch;
+	delete[] parameterSnapshotDirty;
+	delete[] smoothableSnapshotIndex;
+
+	parameterSnapshot = new double[numPluginParameters];
+	parameterTargetSnapshot = new double[numPluginParameters];
+	parameterSnapshotScratch = new double[numPluginParameters];
+	parameterTargetSnapshotScratch = new double[numPluginParameters];
+	parameterSnapshotDirty = new bool[numPluginParameters];
+	smoothableSnapshotIndex = new uint32_t[numSmoothablePluginParameters > 0 ? numSmoothablePluginParameters : 1];
+
+	m = 0;
+	for (unsigned int i = 0; i < numPluginParameters; i++)
+	{
+		bool isMeter = pluginParameters[i]->getControlVariableType() == controlVariableType::kMeter;
+		pluginParameters[i]->setParameterChangeCounter(isMeter ? nullptr : &parameterChangeCounter);
+
+		parameterSnapshot[i] = pluginParameters[i]->getControlValue();
+		parameterTargetSnapshot[i] = pluginParameters[i]->getTargetControlValue();
+		parameterSnapshotScratch[i] = parameterSnapshot[i];
+		parameterTargetSnapshotScratch[i] = parameterTargetSnapshot[i];
+		parameterSnapshotDirty[i] = true;
+
+		if (pluginParameters[i]->getControlVariableType() == controlVariableType::kDouble ||
+			pluginParameters[i]->getControlVariableType() == controlVariableType::kFloat)
+			smoothableSnapshotIndex[m++] = i;
+	}
+
+	// --- dense controlID -> index table for O(1) audio-thread lookups; control IDs are small enums in practice
+	delete[] controlIDToIndexTable;
+	controlIDToIndexTable = nullptr;
+	controlIDToIndexTableSize = 0;
+
+	uint32_t maxControlID = 0;
+	bool denseControlIDs = true;
+	for (unsigned int i = 0; i < numPluginParameters; i++)
+	{
+		uint32_t controlID = pluginParameters[i]->getControlID();
+		if (controlID >= MAX_CONTROL_ID_TABLE_SIZE)
+			denseControlIDs = false;
+		else if (controlID > maxControlID)
+			maxControlID = controlID;
+	}
+
+	if (denseControlIDs && numPluginParameters > 0)
+	{
+		controlIDToIndexTableSize = maxControlID + 1;
+		controlIDToIndexTable = new int32_t[controlIDToIndexTableSize];
+		for (unsigned int i = 0; i < controlIDToIndexTableSize; i++)
+			controlIDToIndexTable[i] = -1;
+
+		// --- first one wins, matching the map's insert( )
+		for (unsigned int i = 0; i < numPluginParameters; i++)
+		{
+			uint32_t controlID = pluginParameters[i]->getControlID();
+			if (controlIDToIndexTable[controlID] < 0)
+				controlIDToIndexTable[controlID] = (int32_t)i;
+		}
+	}
+
+	// --- sub-block scheduler lanes, one per parameter at most
+	delete[] automatedParameterIndex;
+	delete[] automationPointIndex;
+	delete[] automationSegmentOffset;
+	delete[] parameterSmootherIndex;
+
+	uint32_t numLanes = numPluginParameters > 0 ? numPluginParameters : 1;
+	automatedParameterIndex = new uint32_t[numLanes];
+	automationPointIndex = new uint32_t[numLanes];
+	automationSegmentOffset = new uint32_t[numLanes];
+	parameterSmootherIndex = new int32_t[numLanes];
+	numAutomatedParameters = 0;
+
+	for (unsigned int i = 0; i < numPluginParameters; i++)
+		parameterSmootherIndex[i] = -1;
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+		parameterSmootherIndex[smoothableSnapshotIndex[i]] = (int32_t)i;
+
+	// --- GUI change flags; start with everything flagged so the first GUI tick syncs every control
+	delete[] guiParameterChangeFlags;
+	numGUIParameterChangeWords = (numPluginParameters + 63) / 64;
+	guiParameterChangeFlags = new std::atomic<uint64_t>[numGUIParameterChangeWords > 0 ? numGUIParameterChangeWords : 1];
+	for (unsigned int i = 0; i < numGUIParameterChangeWords; i++)
+		guiParameterChangeFlags[i].store(~(uint64_t)0, std::memory_order_relaxed);
+
+	for (unsigned int i = 0; i < numPluginParameters; i++)
+		pluginParameters[i]->setGUIChangeFlag(&guiParameterChangeFlags[i / 64], (uint64_t)1 << (i % 64));
+
+	// --- force a full sync on the first buffer
+	parameterSnapshotValid = false;
+
+	// --- smoother bank, one smoother per smoothable parameter
+	smootherBank.init(numSmoothablePluginParameters);
+	smootherBank.setSampleRate(audioProcDescriptor.sampleRate);
+	for (unsigned int i = 0; i < numSmoothablePluginParameters; i++)
+	{
+		PluginParameter* piParam = smoothablePluginParameters[i];
+		smootherBank.configure(i, piParam->getParameterSmoothing(), piParam->getSmoothingMethod(), piParam->getSmoothingTimeMsec(),
+							   piParam->getMinValue(), piParam->getMaxValue(), piParam->getControlValue());
+	}
+	smootherFrame = SMOOTHER_BLOCK_SIZE - 1;
+
 }
 
 /**
@@ -193,6 +193,7 @@ The AAX plugin shell consists of the following files:
 #define __PluginBase__
 
 #include "pluginparameter.h"
+#include "rtsafetywatchdog.h"
 
 #include <map>
 
@@ -253,12 +254,34 @@ public:
 	/** Buffer Proc Cycle: I connects GUI control changes to bound variables (part of ASPiK input variable binding option) */
 	void syncInBoundVariables();
 
+	/** Buffer Proc Cycle: I (a) picks up a consistent, lock-free copy of all parameter values; called from syncInBoundVariables */
+	bool updateParameterSnapshot();
+
+	/** bracket multi-parameter changes (preset or state loads) so the audio thread never sees half of them (thread-safe) */
+	void beginParameterBatch() { parameterBatchDepth.fetch_add(1, std::memory_order_acq_rel); }
+
+	/** end of a multi-parameter change; see beginParameterBatch( ) */
+	void endParameterBatch()
+	{
+		parameterBatchDepth.fetch_sub(1, std::memory_order_acq_rel);
+		parameterChangeCounter.fetch_add(1, std::memory_order_release);
+	}
+
 	/** Buffer Proc Cycle: II PluginCore overrides this method to process frames */
 	virtual bool processAudioBuffers(ProcessBufferInfo& processInfo);
 
+	/** Buffer Proc Cycle: II (optional) render one scheduler sub-block straight from the float or double buffers; return false to use the frame loop */
+	virtual bool processAudioSubBlock(ProcessBufferInfo& processInfo, uint32_t startFrame, uint32_t numFrames) { return false; }
+
 	/** Buffer Proc Cycle: III connects meter variables to outbound GUI control changes (part of ASPiK output variable binding option) */
 	bool updateOutBoundVariables();
 
+	/** GUI timer: collect (and clear) the control IDs of parameters whose values changed since the last call (lock-free) */
+	bool getGUIParameterChanges(std::vector<int32_t>& changedControlIDs);
+
+	/** flag a parameter as changed for the GUI, e.g. after a shell updates its own copy of the value (lock-free) */
+	void markGUIParameterChanged(int32_t controlID);
+
 	/** notification that a GUI parameter changed. NOT for updating internal states or variables; unused at base class level */
 	virtual bool guiParameterChanged(int32_t controlID, double actualValue) { return true; }
 
@@ -268,8 +291,19 @@ public:
 	/** ASPiK midi event system: base class implementation is empty */
 	virtual bool processMIDIEvent(midiEvent& event) { return true; }
 
-	/** perform parameter smoothing or VST3 sample accurate upates */
-	void doSampleAccurateParameterUpdates();
+	/** perform per-sample parameter smoothing; returns true if bound variables changed since the last call */
+	bool doSampleAccurateParameterUpdates();
+
+	/** per-sample smoothed values of a parameter for the current SMOOTHER_BLOCK_SIZE chunk, or nullptr if the parameter is not smoothable
+	    or not ramping in this chunk (its bound variable is current then) */
+	const double* getSmoothingRamp(int32_t controlID);
+
+	/** index into getSmoothingRamp( ) of the value applied by the last doSampleAccurateParameterUpdates( ) call */
+	uint32_t getSmoothingRampFrame() { return smootherFrame; }
+
+	/** true if doSampleAccurateParameterUpdates( ) cannot report a change before the next scheduler sub-block: nothing pending and every smoother
+	    idle at its target; the smoother of rampedControlID may keep ramping if the caller reads it with getSmoothingRamp( ) */
+	bool parameterUpdatesSettled(int32_t rampedControlID = -1);
 
 	/** only for a vector joystick control from DAW that implements it (reserved for future use): base class implementation is empty */
 	virtual bool setVectorJoystickParameters(const VectorJoystickData& vectorJoysickData) { return true; }
@@ -293,13 +327,54 @@ public:
 	PluginParameter* getPluginParameterByIndex(int32_t index) { return pluginParameters[index]; }
 
 	/**
-	\brief get a parameter by control ID - uses map (slowest)
+	\brief get a parameter's index (into the vector or old-fashioned C-array) by control ID
+
+	NOTES:
+	- O(1) dense table lookup once initPluginParameterArray( ) has run; never allocates, safe on the audio thread
+	- before that (or for very sparse control IDs) falls back to a map search
 
 	\param controlID the control ID of the parameter
 
-	\return a naked pointer to the PluginParameter object
+	\return the index of the parameter, or -1 if there is no parameter with that control ID
 	*/
-	PluginParameter* getPluginParameterByControlID(int32_t controlID) { return pluginParameterMap[controlID]; }
+	int32_t getPluginParameterIndexByControlID(int32_t controlID)
+	{
+		if (controlIDToIndexTable)
+			return (uint32_t)controlID < controlIDToIndexTableSize ? controlIDToIndexTable[controlID] : -1;
+
+		pluginParameterControlIDMap::iterator it = pluginParameterMap.find(controlID);
+		if (it == pluginParameterMap.end() || !it->second)
+			return -1;
+
+		for (uint32_t i = 0; i < pluginParameters.size(); i++)
+		{
+			if (pluginParameters[i] == it->second)
+				return (int32_t)i;
+		}
+		return -1;
+	}
+
+	/**
+	\brief get a parameter by control ID - dense table lookup (see getPluginParameterIndexByControlID( ))
+
+	\param controlID the control ID of the parameter
+
+	\return a naked pointer to the PluginParameter object, or nullptr if there is no parameter with that control ID
+	*/
+	PluginParameter* getPluginParameterByControlID(int32_t controlID)
+	{
+		if (controlIDToIndexTable)
+		{
+			if ((uint32_t)controlID >= controlIDToIndexTableSize)
+				return nullptr;
+			int32_t index = controlIDToIndexTable[controlID];
+			return index < 0 ? nullptr : pluginParameterArray[index];
+		}
+
+		// --- find( ), not operator[ ], so a miss does not insert a null entry
+		pluginParameterControlIDMap::iterator it = pluginParameterMap.find(controlID);
+		return it == pluginParameterMap.end() ? nullptr : it->second;
+	}
 
 	/** get a parameter by type - used to find all meter variables for writing to GUI */
 	PluginParameter* getNextParameterOfType(int32_t& startIndex, controlVariableType controlType);
@@ -322,6 +397,19 @@ public:
 	/** query for Pro Tools meter value*/
 	double getProToolsGRValue();
 
+	/**
+	\brief get the buffer processing CPU statistics (thread-safe, lock-free)
+
+	\return the statistics in a ProcessTimingInfo structure
+	*/
+	ProcessTimingInfo getProcessTimingInfo() { return processTimer.getProcessTimingInfo(); }
+
+	/** clear the buffer processing CPU statistics (thread-safe; takes effect at the next buffer) */
+	void resetProcessTiming() { processTimer.resetProcessTiming(); }
+
+	/** turn the buffer processing CPU statistics on or off (thread-safe) */
+	void setEnableProcessTiming(bool enable) { processTimer.setEnableTiming(enable); }
+
 	/** helper to easily add new I/O combination */
 	uint32_t addSupportedIOCombination(ChannelIOConfig ioConfig);
 
@@ -590,11 +678,11 @@ protected:
 	AudioProcDescriptor audioProcDescriptor;	///< current audio processing description
 	PluginInfo pluginInfo;						///< info about the DLL (component) itself, includes path to DLL
 
-    // --- arrays for frame processing
-    float inputFrame[MAX_CHANNEL_COUNT];		///< input array for frame processing
-    float outputFrame[MAX_CHANNEL_COUNT];		///< output array for frame processing
-    float auxInputFrame[MAX_CHANNEL_COUNT];		///< aux input array for frame processing
-    float auxOutputFrame[MAX_CHANNEL_COUNT];	///< aux output array for frame processing
+    // --- arrays for frame processing; double, so 64-bit host buffers pass through untouched
+    double inputFrame[MAX_CHANNEL_COUNT];		///< input array for frame processing
+    double outputFrame[MAX_CHANNEL_COUNT];		///< output array for frame processing
+    double auxInputFrame[MAX_CHANNEL_COUNT];	///< aux input array for frame processing
+    double auxOutputFrame[MAX_CHANNEL_COUNT];	///< aux output array for frame processing
 
 	// --- ultra-fast access for real-time audio processing
 	PluginParameter** pluginParameterArray = nullptr;			///< old-fashioned C-arrays of pointers for ultra-fast access for real-time audio processing
@@ -604,6 +692,93 @@ protected:
 	PluginParameter** outboundPluginParameters = nullptr;		///< old-fashioned C-arrays of pointers for outbound (meter) parameters
 	uint32_t numOutboundPluginParameters = 0;					///< total number of outbound (meter) parameters
 
+	// --- lock-free parameter snapshot (seqlock style); contiguous arrays indexed like pluginParameterArray
+	std::atomic<uint32_t> parameterChangeCounter{ 0 };			///< bumped by every parameter write, from any thread
+	std::atomic<int32_t> parameterBatchDepth{ 0 };				///< > 0 while a preset or state load is in progress
+	uint32_t parameterSnapshotVersion = 0;						///< parameterChangeCounter value the snapshot was taken at
+	bool parameterSnapshotValid = false;						///< false until the first complete copy
+	double* parameterSnapshot = nullptr;						///< control values, one per parameter
+	double* parameterTargetSnapshot = nullptr;					///< smoothing targets (or control values), one per parameter
+	double* parameterSnapshotScratch = nullptr;					///< copy area for control values; committed only if consistent
+	double* parameterTargetSnapshotScratch = nullptr;			///< copy area for targets
+	bool* parameterSnapshotDirty = nullptr;						///< per-parameter flag: control value changed with the last snapshot
+	uint32_t* smoothableSnapshotIndex = nullptr;				///< maps smoothablePluginParameters[i] to its snapshot index
+
+	// --- dense controlID -> index table, built in initPluginParameterArray( ); -1 = no such parameter
+	int32_t* controlIDToIndexTable = nullptr;					///< old-fashioned C-array, indexed by controlID
+	uint32_t controlIDToIndexTableSize = 0;						///< max controlID + 1
+
+	// --- GUI change flags: one bit per parameter (indexed like pluginParameterArray), set on value changes, cleared by the GUI timer
+	std::atomic<uint64_t>* guiParameterChangeFlags = nullptr;	///< old-fashioned C-array of 64-bit flag words
+	uint32_t numGUIParameterChangeWords = 0;					///< number of flag words
+
+	// --- sub-block scheduler for VST3 sample accurate automation (see processAudioBuffers( )); indexed by automation lane
+	uint32_t* automatedParameterIndex = nullptr;				///< pluginParameterArray index of each parameter with automation points this buffer
+	uint32_t* automationPointIndex = nullptr;					///< next automation point to reach
+	uint32_t* automationSegmentOffset = nullptr;				///< sample offset of the point the current ramp segment heads for
+	int32_t* parameterSmootherIndex = nullptr;					///< maps pluginParameterArray[i] to its smoother, or -1
+	uint32_t numAutomatedParameters = 0;						///< number of automation lanes this buffer
+	bool pendingParameterUpdate = true;							///< bound variables changed outside of the smoothers (reported by doSampleAccurateParameterUpdates( ))
+
+	/** frame loop over [startFrame, endFrame) for float or double (VST3 kSample64) buffers */
+	template <typename SampleType>
+	void processFrameLoop(ProcessFrameInfo& info, SampleType** inputs, SampleType** outputs, SampleType** auxInputs, SampleType** auxOutputs,
+						  ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t endFrame, bool pollMidi, double sampleInterval)
+	{
+		for (uint32_t frame = startFrame; frame < endFrame; frame++)
+		{
+			for (uint32_t i = 0; i<processBufferInfo.numAudioInChannels; i++)
+			{
+				inputFrame[i] = inputs[i][frame];
+			}
+
+			for (uint32_t i = 0; i<processBufferInfo.numAuxAudioInChannels; i++)
+			{
+				auxInputFrame[i] = auxInputs[i][frame];
+			}
+
+			info.currentFrame = frame;
+
+			// --- queues that cannot be scheduled are polled per frame
+			if (pollMidi)
+				processBufferInfo.midiEventQueue->fireMidiEvents(frame);
+
+			// -- process the frame of data
+			processAudioFrame(info);
+
+			for (uint32_t i = 0; i<processBufferInfo.numAudioOutChannels; i++)
+			{
+				outputs[i][frame] = (SampleType)outputFrame[i];
+			}
+			for (uint32_t i = 0; i<processBufferInfo.numAuxAudioOutChannels; i++)
+			{
+				auxOutputs[i][frame] = (SampleType)auxOutputFrame[i];
+			}
+
+			// --- update per-frame
+			info.hostInfo->uAbsoluteFrameBufferIndex += 1;
+			info.hostInfo->dAbsoluteFrameBufferTime += sampleInterval;
+		}
+	}
+
+	/** sub-block scheduler: pick up this buffer's VST3 sample accurate automation points */
+	void beginSampleAccurateAutomation(uint32_t numFrames);
+
+	/** sub-block scheduler: start ramp segments at a frame; returns the frame of the next automation point */
+	uint32_t applySampleAccurateAutomation(uint32_t frame, uint32_t numFrames);
+
+	/** sub-block scheduler: set the final automation values and release the host queues */
+	void endSampleAccurateAutomation();
+
+	/** sub-block scheduler: apply one normalized automation value to a parameter */
+	void applyAutomationValue(uint32_t parameterIndex, double normalizedValue);
+
+	// --- block-wise parameter smoothing for smoothablePluginParameters
+	SmootherBank smootherBank;									///< SoA smoothing state and ramp buffers
+	uint32_t smootherFrame = SMOOTHER_BLOCK_SIZE - 1;			///< position in the current ramp chunk
+	bool smoothersRamping = false;								///< at least one smoother is ramping in the current chunk
+	bool pendingSmootherTargets = false;						///< the snapshot moved a smoothing target since the smoothers last read them
+
     // --- vectorized version of pluginParameterMap for fast iteration when key not needed
     std::vector<PluginParameter*> pluginParameters;				///< vector version of parameter list
 
@@ -616,6 +791,32 @@ protected:
 
     // --- PRESETS
     std::vector<PresetInfo*> presets;	///< preset list
+
+	// --- CPU instrumentation
+	ProcessTimer processTimer;			///< per-buffer timing statistics, see processAudioBuffers( )
+};
+
+/**
+\class ScopedParameterBatch
+\ingroup ASPiK-Core
+\brief
+Holds a beginParameterBatch( )/endParameterBatch( ) pair open for the lifetime of the object.
+
+Operation:
+- the batch is closed on every return path, so a failed or partial state load cannot leave the audio thread on a stale snapshot
+- a null plugin is allowed and does nothing
+*/
+class ScopedParameterBatch
+{
+public:
+	ScopedParameterBatch(PluginBase* _plugin) : plugin(_plugin) { if (plugin) plugin->beginParameterBatch(); }
+	~ScopedParameterBatch() { if (plugin) plugin->endParameterBatch(); }
+
+private:
+	PluginBase* plugin = nullptr;	///< the plugin whose batch is open
+
+	ScopedParameterBatch(const ScopedParameterBatch&) = delete;
+	ScopedParameterBatch& operator=(const ScopedParameterBatch&) = delete;
 };
 
 #endif /* defined(__PluginBase__) */
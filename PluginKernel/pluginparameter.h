@@ -20,6 +20,7 @@
 #include <map>
 #include <iomanip>
 #include <iostream>
+#include <algorithm>
 
 #include <math.h>
 #include "pluginstructures.h"
@@ -155,6 +156,9 @@ public:
     bool getEnableVSTSampleAccurateAutomation() { return enableVSTSampleAccurateAutomation; }			///< query VST3 sample accurate automation
     void setEnableVSTSampleAccurateAutomation(bool value) { enableVSTSampleAccurateAutomation = value; }///< set VST3 sample accurate automation
 
+    uint32_t getStateVersion() { return stateVersion; }				///< query the first VST3 state version that stores this parameter
+    void setStateVersion(uint32_t value) { stateVersion = value; }	///< set the first VST3 state version that stores this parameter
+
 	// --- for aux attributes
 	AuxParameterAttribute* getAuxAttribute(uint32_t attributeID);										///< get aux data
 	uint32_t setAuxAttribute(uint32_t attributeID, const AuxParameterAttribute& auxParameterAtribute);	///< set aux data
@@ -174,6 +178,8 @@ public:
 	*/
 	inline void setControlValue(double actualParamValue, bool ignoreSmoothing = false)
 	{
+		bool valueChanged = actualParamValue != getTargetControlValue();
+
 		if (controlType == controlVariableType::kDouble ||
 			controlType == controlVariableType::kFloat)
 		{
@@ -184,6 +190,10 @@ public:
 		}
 		else
 			setAtomicControlValueDouble(actualParamValue);
+
+		notifyParameterChange();
+		if (valueChanged)
+			notifyGUIChange();
 	}
 
 	/**
@@ -197,6 +207,7 @@ public:
 	{
 		// --- set according to smoothing option
 		double actualParamValue = getControlValueWithNormalizedValue(normalizedValue, applyTaper);
+		bool valueChanged = actualParamValue != getTargetControlValue();
 
 		if (controlType == controlVariableType::kDouble ||
 			controlType == controlVariableType::kFloat)
@@ -209,9 +220,73 @@ public:
 		else
 			setAtomicControlValueDouble(actualParamValue);
 
+		notifyParameterChange();
+		if (valueChanged)
+			notifyGUIChange();
 		return actualParamValue;
 	}
 
+	/**
+	\brief the value the parameter is heading for: the smoothing target if smoothing, otherwise the control value
+
+	\return the target value as a regular double
+	*/
+	inline double getTargetControlValue()
+	{
+		if (useParameterSmoothing && (controlType == controlVariableType::kDouble || controlType == controlVariableType::kFloat))
+			return getSmoothedTargetValue();
+		return getControlValue();
+	}
+
+	/**
+	\brief write a smoothed value computed elsewhere (e.g. PluginBase's SmootherBank); does not move the smoothing target
+
+	\param smoothedValue the value
+	*/
+	inline void setSmoothedControlValue(double smoothedValue) { setAtomicControlValueDouble(smoothedValue); }
+
+	/**
+	\brief host automation: set the control value AND the smoothing target, so a later parameter snapshot does not
+	smooth back to an old target; PluginBase ramps the value itself
+
+	\param actualParamValue parameter value as a regular double
+	*/
+	inline void setAutomatedControlValue(double actualParamValue)
+	{
+		bool valueChanged = actualParamValue != getTargetControlValue();
+
+		if (controlType == controlVariableType::kDouble ||
+			controlType == controlVariableType::kFloat)
+			setSmoothedTargetValue(actualParamValue);
+		setAtomicControlValueDouble(actualParamValue);
+
+		notifyParameterChange();
+		if (valueChanged)
+			notifyGUIChange();
+	}
+
+	/**
+	\brief set the shared change counter that is bumped on every set-value operation; used by PluginBase
+	to know when its parameter snapshot is stale (not set for meters, which are written by the audio thread)
+
+	\param counter the counter, or nullptr to disable notification
+	*/
+	void setParameterChangeCounter(std::atomic<uint32_t>* counter) { parameterChangeCounter = counter; }
+
+	/**
+	\brief set the GUI change flag word and bit for this parameter; the bit is set whenever the value actually changes
+	so the GUI timer only touches controls whose values moved (see PluginBase::getGUIParameterChanges)
+
+	\param flags the flag word (owned by PluginBase), or nullptr to disable
+	\param bit the bit mask for this parameter in that word
+	*/
+	void setGUIChangeFlag(std::atomic<uint64_t>* flags, uint64_t bit) { guiChangeFlags = flags; guiChangeBit = bit; }
+
+	/**
+	\brief flag this parameter as changed for the GUI (lock-free, any thread)
+	*/
+	void notifyGUIChange() { if (guiChangeFlags) guiChangeFlags->fetch_or(guiChangeBit, std::memory_order_release); }
+
 	/**
 	\brief the main function to access the underlying atomic double value as a string
 
@@ -478,26 +553,34 @@ public:
 
 	\return boundVariableType
 	*/
-	bool updateInBoundVariable()
+	bool updateInBoundVariable() { return updateInBoundVariable(getControlValue()); }
+
+	/**
+	\brief perform the variable binding update with a value read earlier (e.g. from the audio thread's parameter snapshot)
+
+	\param controlValue the value to write
+	\return true if a variable is bound, false otherwise
+	*/
+	bool updateInBoundVariable(double controlValue)
 	{
 		if (boundVariableUInt)
 		{
-			*boundVariableUInt = (uint32_t)getControlValue();
+			*boundVariableUInt = (uint32_t)controlValue;
 			return true;
 		}
 		else if (boundVariableInt)
 		{
-			*boundVariableInt = (int)getControlValue();
+			*boundVariableInt = (int)controlValue;
 			return true;
 		}
 		else if (boundVariableFloat)
 		{
-			*boundVariableFloat = (float)getControlValue();
+			*boundVariableFloat = (float)controlValue;
 			return true;
 		}
 		else if (boundVariableDouble)
 		{
-			*boundVariableDouble = getControlValue();
+			*boundVariableDouble = controlValue;
 			return true;
 		}
 		return false;
@@ -605,6 +688,11 @@ protected:
     void setSmoothedTargetValue(double value){ smoothedTargetValueAtomic.store((float)value); }	///< set atomic TARGET smoothing variable with double
     double getSmoothedTargetValue() const { return (double)smoothedTargetValueAtomic.load(); }	///< set atomic TARGET smoothing variable with double
 
+	std::atomic<uint32_t>* parameterChangeCounter = nullptr;	///< shared change counter (owned by PluginBase)
+	void notifyParameterChange() { if (parameterChangeCounter) parameterChangeCounter->fetch_add(1, std::memory_order_release); } ///< bump the shared counter
+	std::atomic<uint64_t>* guiChangeFlags = nullptr;	///< GUI change flag word (owned by PluginBase)
+	uint64_t guiChangeBit = 0;							///< this parameter's bit in guiChangeFlags
+
     // --- control tweakers
     taper controlTaper = taper::kLinearTaper;	///< the taper
     uint32_t displayPrecision = 2;				///< sig digits for display
@@ -641,6 +729,9 @@ protected:
     // --- default is enabled; you can disable this for controls that have a long postUpdate cooking time
     bool enableVSTSampleAccurateAutomation = true;							///< VST3 sample accurate flag
 
+    // --- parameters added after a release are not in older saved states; loading one of those sets them to their defaults
+    uint32_t stateVersion = 0;												///< first VST3 state version that stores this parameter
+
     /**
 	\brief get volt/octave control value from a normalized value
 
@@ -0,0 +1,64 @@
+// -----------------------------------------------------------------------------
+//    ASPiK Plugin Kernel File:  rtsafetywatchdog.h
+//
+/**
+    \file   rtsafetywatchdog.h
+    \brief  real-time safety watchdog for test builds: flags heap allocations
+    		and mutex locks made on the audio thread
+    		- compiled in only when ENABLE_RT_SAFETY_WATCHDOG is defined
+    		  (CMake option RT_SAFETY_WATCHDOG); otherwise everything here is empty
+    		- http://www.aspikplugins.com
+    		- http://www.willpirkle.com
+*/
+// -----------------------------------------------------------------------------
+#ifndef _RTSafetyWatchdog_H_
+#define _RTSafetyWatchdog_H_
+
+#include <stdint.h>
+
+#ifdef ENABLE_RT_SAFETY_WATCHDOG
+
+/** enter an audio thread section; calls nest (thread-local depth count) */
+void enterRealTimeSection();
+
+/** leave an audio thread section */
+void leaveRealTimeSection();
+
+/** number of allocations/locks seen inside audio thread sections since the last reset (any thread) */
+uint32_t getRealTimeSafetyViolationCount();
+
+/** clear the violation count */
+void resetRealTimeSafetyViolationCount();
+
+/** true: abort( ) on the first violation so a debugger stops right on it (default false: report and carry on) */
+void setRealTimeSafetyAbortOnViolation(bool abortOnViolation);
+
+#endif
+
+/**
+\class ScopedRealTimeSection
+\ingroup ASPiK-Core
+\brief
+Marks the enclosing scope as audio thread code for the real-time safety watchdog.
+
+Operation:
+- with ENABLE_RT_SAFETY_WATCHDOG, every malloc/calloc/realloc/free, operator new/delete and
+  pthread_mutex_lock made by this thread while the object is alive is reported to stderr with a stack trace
+- without it the object is empty and compiles away
+*/
+class ScopedRealTimeSection
+{
+public:
+#ifdef ENABLE_RT_SAFETY_WATCHDOG
+	ScopedRealTimeSection() { enterRealTimeSection(); }
+	~ScopedRealTimeSection() { leaveRealTimeSection(); }
+#else
+	ScopedRealTimeSection() {}
+#endif
+
+private:
+	ScopedRealTimeSection(const ScopedRealTimeSection&) = delete;
+	ScopedRealTimeSection& operator=(const ScopedRealTimeSection&) = delete;
+};
+
+#endif
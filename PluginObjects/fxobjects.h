@@ -22,6 +22,14 @@
 #include "guiconstants.h"
 #include "filters.h"
 #include <time.h>       /* time */
+#include <stdint.h>
+#include <string.h>
+
+// --- hardware fp16 conversion for compact delay storage (-mf16c, or /arch:AVX2 on MSVC; CMake option USE_F16C)
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#include <immintrin.h>
+#define FX_HAVE_F16C 1
+#endif
 
 /** @file fxobjects.h
 \brief HELLO LOOK
@@ -37,6 +45,7 @@ const double kSqrtTwo = pow(2.0, 0.5);
 const double kMinFilterFrequency = 20.0;
 const double kMaxFilterFrequency = 20480.0; // 10 octaves above 20 Hz
 const double ARC4RANDOMMAX = 4294967295.0;  // (2^32 - 1)
+const double kAntiDenormalOffset = 1.0e-18;   // tiny DC to keep recirculating networks out of denormal range (-360 dBFS)
 
 #define NEGATIVE       0
 #define POSITIVE       1
@@ -50,6 +59,8 @@ const double ARC4RANDOMMAX = 4294967295.0;  // (2^32 - 1)
 \ingroup FX-Functions
 
 @brief Perform underflow check; returns true if we did underflow (user may not care)
+- NOTE: the framework enables FTZ/DAZ around processAudioBuffers (see ScopedDenormalGuard) so this is
+  no longer called from the per-sample filter and delay kernels; use it for values computed outside that scope
 
 \param value - the value to check for underflow
 \return true if overflowed, false otherwise
@@ -118,6 +129,115 @@ inline double doLinearInterpolation(double y1, double y2, double fractional_X)
 	return fractional_X*y2 + (1.0 - fractional_X)*y1;
 }
 
+/**
+@doLagrange4Interpolation
+\ingroup FX-Functions
+
+@brief performs 3rd order (4-point) Lagrange interpolation between the middle two of four equally spaced points;
+a fixed-order version of doLagrangeInterpolation( ) for per-sample use in fractional delays
+
+\param y0 - the y coordinate of the point before y1
+\param y1 - the y coordinate of the first point
+\param y2 - the y coordinate of the second point
+\param y3 - the y coordinate of the point after y2
+\param fractional_X - the interpolation location as a fractional distance between y1 and y2
+\return the interpolated value
+*/
+inline double doLagrange4Interpolation(double y0, double y1, double y2, double y3, double fractional_X)
+{
+	double xm1 = fractional_X - 1.0;
+	double xm2 = fractional_X - 2.0;
+	double xp1 = fractional_X + 1.0;
+
+	return -y0*fractional_X*xm1*xm2 / 6.0 + y1*xp1*xm1*xm2 / 2.0
+		   - y2*xp1*fractional_X*xm2 / 2.0 + y3*xp1*fractional_X*xm1 / 6.0;
+}
+
+/**
+@floatToHalf
+\ingroup FX-Functions
+
+@brief converts a float to IEEE 754 half precision (fp16) with round-to-nearest-even; uses the F16C instruction
+when the compiler targets it, otherwise the bit-exact software equivalent
+
+\param value - the float to convert
+\return the fp16 bit pattern
+*/
+inline uint16_t floatToHalf(float value)
+{
+#ifdef FX_HAVE_F16C
+	return (uint16_t)_cvtss_sh(value, 0);
+#else
+	uint32_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	uint32_t sign = bits & 0x80000000u;
+	bits ^= sign;
+
+	uint16_t half = 0;
+	if (bits >= 0x47800000u)		// --- too big for fp16: Inf, or NaN stays NaN
+		half = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+	else if (bits < 0x38800000u)	// --- fp16 subnormal or zero: let the FPU round by adding a magic number
+	{
+		const uint32_t denormMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+		float denormMagic = 0.0f;
+		memcpy(&denormMagic, &denormMagicBits, sizeof(denormMagic));
+		float f = 0.0f;
+		memcpy(&f, &bits, sizeof(f));
+		f += denormMagic;
+		memcpy(&bits, &f, sizeof(bits));
+		half = (uint16_t)(bits - denormMagicBits);
+	}
+	else							// --- normal: rebias the exponent and round the mantissa to 10 bits
+	{
+		uint32_t mantissaOdd = (bits >> 13) & 1;
+		bits += ((uint32_t)(15 - 127) << 23) + 0xfff;
+		bits += mantissaOdd;
+		half = (uint16_t)(bits >> 13);
+	}
+	return (uint16_t)(half | (sign >> 16));
+#endif
+}
+
+/**
+@halfToFloat
+\ingroup FX-Functions
+
+@brief converts an IEEE 754 half precision (fp16) bit pattern to float; exact, uses F16C when available
+
+\param half - the fp16 bit pattern
+\return the value as a float
+*/
+inline float halfToFloat(uint16_t half)
+{
+#ifdef FX_HAVE_F16C
+	return _cvtsh_ss(half);
+#else
+	const uint32_t shiftedExponent = 0x7c00u << 13;
+	uint32_t bits = (uint32_t)(half & 0x7fff) << 13;
+	uint32_t exponent = bits & shiftedExponent;
+	bits += (uint32_t)(127 - 15) << 23;
+
+	if (exponent == shiftedExponent)	// --- Inf/NaN
+		bits += (uint32_t)(128 - 16) << 23;
+	else if (exponent == 0)				// --- zero/subnormal: renormalize with the FPU
+	{
+		const uint32_t magicBits = 113u << 23;
+		float magic = 0.0f;
+		memcpy(&magic, &magicBits, sizeof(magic));
+		bits += 1u << 23;
+		float f = 0.0f;
+		memcpy(&f, &bits, sizeof(f));
+		f -= magic;
+		memcpy(&bits, &f, sizeof(bits));
+	}
+	bits |= (uint32_t)(half & 0x8000) << 16;
+
+	float value = 0.0f;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+#endif
+}
+
 /**
 @doLagrangeInterpolation
 \ingroup FX-Functions
@@ -1040,6 +1160,22 @@ inline double principalArg(double phaseIn)
 
 enum class interpolation {kLinear, kLagrange4};
 
+/**
+\enum bufferStorage
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to choose how a CircularBuffer stores its samples; reads and writes always use the
+buffer's own type T, so only the memory footprint and precision change.
+
+- kNative: T (double for the delay objects, 8 bytes)
+- kFloat: 32-bit float, 4 bytes (24 bit mantissa, far below audibility)
+- kHalf: IEEE fp16, 2 bytes (11 bit mantissa, ~-66dB relative error; constant relative precision suits decaying tails)
+- kInt16: 16-bit fixed point scaled to a full scale value, 2 bytes (~-96dB re full scale; clips above it)
+
+- enum class bufferStorage { kNative, kFloat, kHalf, kInt16 };
+*/
+enum class bufferStorage { kNative, kFloat, kHalf, kInt16 };
+
 /**
 @resample
 \ingroup FX-Functions
@@ -2282,6 +2418,7 @@ private:
 \ingroup FX-Objects
 \brief
 The CircularBuffer object implements a simple circular buffer. It uses a wrap mask to wrap the read or write index quickly.
+The samples can be stored as T or in a compact format (see bufferStorage and setStorageType( )).
 
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
@@ -2298,8 +2435,53 @@ public:
 	CircularBuffer() {}		/* C-TOR */
 	~CircularBuffer() {}	/* D-TOR */
 
-							/** flush buffer by resetting all values to 0.0 */
-	void flushBuffer(){ memset(&buffer[0], 0, bufferLength * sizeof(T)); }
+	/** flush buffer by resetting all values to 0.0 (all-zero bits in every storage format) */
+	void flushBuffer()
+	{
+		switch (storageType)
+		{
+			case bufferStorage::kFloat: memset(&floatBuffer[0], 0, bufferLength * sizeof(float)); break;
+			case bufferStorage::kHalf:
+			case bufferStorage::kInt16: memset(&compactBuffer[0], 0, bufferLength * sizeof(uint16_t)); break;
+			default: memset(&buffer[0], 0, bufferLength * sizeof(T)); break;
+		}
+	}
+
+	/** choose the sample storage; takes effect at the next createCircularBuffer( ), which has to allocate if the
+	    storage changed, so do NOT call from the realtime audio thread; do this prior to any processing */
+	/**
+	\param type the storage format
+	\param int16FullScale for kInt16 only: the largest magnitude that can be stored (larger values clip)
+	*/
+	void setStorageType(bufferStorage type, double int16FullScale = 2.0)
+	{
+		if (type != storageType)
+		{
+			// --- release the old storage; the next create allocates the new one
+			buffer.reset();
+			floatBuffer.reset();
+			compactBuffer.reset();
+			bufferCapacity = 0;
+			storageType = type;
+		}
+		int16Scale = 32767.0 / int16FullScale;
+		int16InverseScale = int16FullScale / 32767.0;
+	}
+
+	/** get the sample storage format */
+	bufferStorage getStorageType() { return storageType; }
+
+	/** bytes per stored sample */
+	size_t getStorageBytesPerSample()
+	{
+		switch (storageType)
+		{
+			case bufferStorage::kFloat: return sizeof(float);
+			case bufferStorage::kHalf:
+			case bufferStorage::kInt16: return sizeof(uint16_t);
+			default: return sizeof(T);
+		}
+	}
 
 	/** Create a buffer based on a target maximum in SAMPLES
 	//	   do NOT call from realtime audio thread; do this prior to any processing */
@@ -2310,7 +2492,8 @@ public:
 	}
 
 	/** Create a buffer based on a target maximum in SAMPLESwhere the size is
-	    pre-calculated as a power of two */
+	    pre-calculated as a power of two; memory is only allocated if the buffer has to grow,
+		so create the largest buffer first and later (smaller) creates are allocation-free */
 	void createCircularBufferPowerOfTwo(unsigned int _bufferLengthPowerOfTwo)
 	{
 		// --- reset to top
@@ -2322,8 +2505,18 @@ public:
 		// --- save (bufferLength - 1) for use as wrapping mask
 		wrapMask = bufferLength - 1;
 
-		// --- create new buffer
-		buffer.reset(new T[bufferLength]);
+		// --- create new buffer, unless the existing one is big enough
+		if (bufferLength > bufferCapacity)
+		{
+			switch (storageType)
+			{
+				case bufferStorage::kFloat: floatBuffer.reset(new float[bufferLength]); break;
+				case bufferStorage::kHalf:
+				case bufferStorage::kInt16: compactBuffer.reset(new uint16_t[bufferLength]); break;
+				default: buffer.reset(new T[bufferLength]); break;
+			}
+			bufferCapacity = bufferLength;
+		}
 
 		// --- flush buffer
 		flushBuffer();
@@ -2333,7 +2526,21 @@ public:
 	void writeBuffer(T input)
 	{
 		// --- write and increment index counter
-		buffer[writeIndex++] = input;
+		switch (storageType)
+		{
+			case bufferStorage::kNative: buffer[writeIndex] = input; break;
+			case bufferStorage::kFloat: floatBuffer[writeIndex] = (float)input; break;
+			case bufferStorage::kHalf: compactBuffer[writeIndex] = floatToHalf((float)input); break;
+			case bufferStorage::kInt16:
+			{
+				// --- round and clip to the int16 range
+				double scaled = (double)input*int16Scale;
+				scaled = scaled > 32767.0 ? 32767.0 : (scaled < -32767.0 ? -32767.0 : scaled);
+				compactBuffer[writeIndex] = (uint16_t)(int16_t)(scaled < 0.0 ? scaled - 0.5 : scaled + 0.5);
+				break;
+			}
+		}
+		writeIndex++;
 
 		// --- wrap if index > bufferlength - 1
 		writeIndex &= wrapMask;
@@ -2351,7 +2558,13 @@ public:
 		readIndex &= wrapMask;
 
 		// --- read it
-		return buffer[readIndex];
+		switch (storageType)
+		{
+			case bufferStorage::kFloat: return (T)floatBuffer[readIndex];
+			case bufferStorage::kHalf: return (T)halfToFloat(compactBuffer[readIndex]);
+			case bufferStorage::kInt16: return (T)((int16_t)compactBuffer[readIndex] * int16InverseScale);
+			default: return buffer[readIndex];
+		}
 	}
 
 	/** read an arbitrary location that includes a fractional sample */
@@ -2371,6 +2584,14 @@ public:
 		// --- get fractional part
 		double fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
 
+		// --- 4-point Lagrange needs one NEWER sample, so not at the very front of the buffer
+		if (interpolationType == interpolation::kLagrange4 && delayInFractionalSamples >= 1.0)
+		{
+			T y0 = readBuffer((int)delayInFractionalSamples - 1);
+			T y3 = readBuffer((int)delayInFractionalSamples + 2);
+			return doLagrange4Interpolation(y0, y1, y2, y3, fraction);
+		}
+
 		// --- do the interpolation (you could try different types here)
 		return doLinearInterpolation(y1, y2, fraction);
 	}
@@ -2378,12 +2599,22 @@ public:
 	/** enable or disable interpolation; usually used for diagnostics or in algorithms that require strict integer samples times */
 	void setInterpolate(bool b) { interpolate = b; }
 
+	/** choose the fractional read interpolator: linear (default) or 4-point Lagrange (costs two more reads) */
+	void setInterpolationType(interpolation type) { interpolationType = type; }
+
 private:
 	std::unique_ptr<T[]> buffer = nullptr;	///< smart pointer will auto-delete
+	std::unique_ptr<float[]> floatBuffer = nullptr;		///< kFloat storage
+	std::unique_ptr<uint16_t[]> compactBuffer = nullptr;	///< kHalf and kInt16 storage
+	bufferStorage storageType = bufferStorage::kNative;	///< storage format of the samples
+	double int16Scale = 32767.0 / 2.0;			///< kInt16: full scale to 32767
+	double int16InverseScale = 2.0 / 32767.0;	///< kInt16: 32767 to full scale
 	unsigned int writeIndex = 0;		///> write index
 	unsigned int bufferLength = 1024;	///< must be nearest power of 2
 	unsigned int wrapMask = 1023;		///< must be (bufferLength - 1)
+	unsigned int bufferCapacity = 0;	///< allocated length of the current storage; may be larger than bufferLength
 	bool interpolate = true;			///< interpolation (default is ON)
+	interpolation interpolationType = interpolation::kLinear; ///< fractional read interpolator
 };
 
 
@@ -3820,6 +4051,7 @@ struct SimpleDelayParameters
 
 		delayTime_mSec = params.delayTime_mSec;
 		interpolate = params.interpolate;
+		interpolationType = params.interpolationType;
 		delay_Samples = params.delay_Samples;
 		return *this;
 	}
@@ -3827,6 +4059,7 @@ struct SimpleDelayParameters
 	// --- individual parameters
 	double delayTime_mSec = 0.0;	///< delay tine in mSec
 	bool interpolate = false;		///< interpolation flag (diagnostics usually)
+	interpolation interpolationType = interpolation::kLinear; ///< interpolator used when interpolate is set
 
 	// --- outbound parameters
 	double delay_Samples = 0.0;		///< current delay in samples; other objects may need to access this information
@@ -3891,6 +4124,7 @@ public:
 		simpleDelayParameters = params;
 		simpleDelayParameters.delay_Samples = simpleDelayParameters.delayTime_mSec*(samplesPerMSec);
 		delayBuffer.setInterpolate(simpleDelayParameters.interpolate);
+		delayBuffer.setInterpolationType(simpleDelayParameters.interpolationType);
 	}
 
 	/** process MONO audio delay */
@@ -3962,6 +4196,18 @@ public:
 		delayBuffer.writeBuffer(xn);
 	}
 
+	/** clear the delay line without re-allocating; safe to call from the audio thread */
+	void flushDelay()
+	{
+		delayBuffer.flushBuffer();
+	}
+
+	/** choose the sample storage (see bufferStorage); call before createDelayBuffer( ), not from the audio thread */
+	void setStorageType(bufferStorage type, double int16FullScale = 2.0)
+	{
+		delayBuffer.setStorageType(type, int16FullScale);
+	}
+
 private:
 	SimpleDelayParameters simpleDelayParameters; ///< object parameters
 
@@ -4162,6 +4408,7 @@ struct DelayAPFParameters
 		enableLPF = params.enableLPF;
 		lpf_g = params.lpf_g;
 		interpolate = params.interpolate;
+		interpolationType = params.interpolationType;
 		enableLFO = params.enableLFO;
 		lfoRate_Hz = params.lfoRate_Hz;
 		lfoDepth = params.lfoDepth;
@@ -4175,6 +4422,7 @@ struct DelayAPFParameters
 	bool enableLPF = false;			///< flag to enable LPF in structure
 	double lpf_g = 0.0;				///< LPF g coefficient (if enabled)
 	bool interpolate = false;		///< interpolate flag (diagnostics)
+	interpolation interpolationType = interpolation::kLinear; ///< interpolator used when interpolate is set
 	bool enableLFO = false;			///< flag to enable LFO
 	double lfoRate_Hz = 0.0;		///< LFO rate in Hz, if enabled
 	double lfoDepth = 0.0;			///< LFO deoth (not in %) if enabled
@@ -4271,9 +4519,6 @@ public:
 		// form y(n) = -gw(n) + w(n-D)
 		double yn = -apf_g*wn + wnD;
 
-		// underflow check
-		checkFloatUnderflow(yn);
-
 		// write delay line
 		delay.writeDelay(wn);
 
@@ -4284,6 +4529,13 @@ public:
 		return delay.readDelayAtTime_mSec(delayTime);
 	}
 
+	/** clear the delay line and LPF state without re-allocating; safe to call from the audio thread */
+	void flushDelay()
+	{
+		delay.flushDelay();
+		lpf_state = 0.0;
+	}
+
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
@@ -4307,6 +4559,8 @@ public:
 		// --- update delay line
 		SimpleDelayParameters delayParams = delay.getParameters();
 		delayParams.delayTime_mSec = delayAPFParameters.delayTime_mSec;
+		delayParams.interpolate = delayAPFParameters.interpolate;
+		delayParams.interpolationType = delayAPFParameters.interpolationType;
 		delay.setParameters(delayParams);
 	}
 
@@ -4477,9 +4731,6 @@ public:
 		// --- form y(n) = -gw(n) + w(n-D)
 		double yn = -apf_g*wn + wnD;
 
-		// --- underflow check
-		checkFloatUnderflow(yn);
-
 		// --- write delay line
 		delay.writeDelay(ynInner);
 
@@ -4536,177 +4787,773 @@ private:
 	DelayAPF nestedAPF;	///< nested APF object
 };
 
+// --- constants for the input diffuser
+const unsigned int INPUT_DIFFUSER_STAGES = 4;		///< allpass stages in the cascade
+const unsigned int INPUT_DIFFUSER_CHUNK = 256;		///< longest run processed per stage in one pass; also the mirror length
+
 /**
-\struct TwoBandShelvingFilterParameters
+\struct InputDiffuserParameters
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the TwoBandShelvingFilter object. Used for reverb algorithms in book.
-
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
+Custom parameter structure for the InputDiffuser object.
 */
-struct TwoBandShelvingFilterParameters
+struct InputDiffuserParameters
 {
-	TwoBandShelvingFilterParameters() {}
+	InputDiffuserParameters() {}
 	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	TwoBandShelvingFilterParameters& operator=(const TwoBandShelvingFilterParameters& params)	// need this override for collections to work
+	InputDiffuserParameters& operator=(const InputDiffuserParameters& params)	// need this override for collections to work
 	{
 		if (this == &params)
 			return *this;
 
-		lowShelf_fc = params.lowShelf_fc;
-		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
-		highShelf_fc = params.highShelf_fc;
-		highShelfBoostCut_dB = params.highShelfBoostCut_dB;
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+		{
+			delayTime_mSec[i] = params.delayTime_mSec[i];
+			apf_g[i] = params.apf_g[i];
+		}
 		return *this;
 	}
 
 	// --- individual parameters
-	double lowShelf_fc = 0.0;			///< fc for low shelf
-	double lowShelfBoostCut_dB = 0.0;	///< low shelf gain
-	double highShelf_fc = 0.0;			///< fc for high shelf
-	double highShelfBoostCut_dB = 0.0;	///< high shelf gain
+	double delayTime_mSec[INPUT_DIFFUSER_STAGES] = { 0.0 };	///< APF delay time per stage
+	double apf_g[INPUT_DIFFUSER_STAGES] = { 0.0 };			///< APF g coefficient per stage
 };
 
 /**
-\class TwoBandShelvingFilter
+\class InputDiffuser
 \ingroup FX-Objects
 \brief
-The TwoBandShelvingFilter object implements two shelving filters in series in the standard "Bass and Treble" configuration.
+The InputDiffuser object implements a fixed cascade of INPUT_DIFFUSER_STAGES non-modulated delaying APFs with integer
+delays, the Schroeder input diffuser of a plate reverb. Each stage gives exactly the same output as a DelayAPF with
+interpolation, LFO and LPF off.
 
 Audio I/O:
-- Processes mono input to mono output.
+- Processes mono input to mono output, one sample or a block at a time.
 
 Control I/F:
-- Use TwoBandShelvingFilterParameters structure to get/set object params.
+- Use InputDiffuserParameters structure to get/set object params.
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
+Operation:
+- processAudioBlock( ) runs the whole block through one stage before moving on to the next; inside a stage it works
+  in runs of up to min(D + 1, INPUT_DIFFUSER_CHUNK) samples, which never read a sample written in the same run, so
+  the inner loop has no loop-carried dependency and vectorizes
+- each delay line is a power of two long with an INPUT_DIFFUSER_CHUNK sample mirror of its start appended, so a
+  run reads contiguous memory with no wrapping
+- a stage with a delay of less than one sample passes its input through
+- call createDelayBuffers( ) once (from initialize) with the highest sample rate; reset( ) only re-uses that memory
 */
-class TwoBandShelvingFilter : public IAudioSignalProcessor
+class InputDiffuser : public IAudioSignalProcessor
 {
 public:
-	TwoBandShelvingFilter()
-	{
-		AudioFilterParameters params = lowShelfFilter.getParameters();
-		params.algorithm = filterAlgorithm::kLowShelf;
-		lowShelfFilter.setParameters(params);
-
-		params = highShelfFilter.getParameters();
-		params.algorithm = filterAlgorithm::kHiShelf;
-		highShelfFilter.setParameters(params);
-	}		/* C-TOR */
-
-	~TwoBandShelvingFilter() {}		/* D-TOR */
+	InputDiffuser() {}		/* C-TOR */
+	~InputDiffuser() {}		/* D-TOR */
 
 	/** reset members to initialized state */
 	virtual bool reset(double _sampleRate)
 	{
-		lowShelfFilter.reset(_sampleRate);
-		highShelfFilter.reset(_sampleRate);
+		sampleRate = _sampleRate;
+		calculateDelays();
+		flushDelays();
 		return true;
 	}
 
+	/** create the delay buffers; allocates only if a stage needs more memory than it already has */
+	/**
+	\param _sampleRate the highest sample rate the object will run at
+	\param maxDelay_mSec array of INPUT_DIFFUSER_STAGES longest delay times, one per stage
+	*/
+	void createDelayBuffers(double _sampleRate, const double* maxDelay_mSec)
+	{
+		sampleRate = _sampleRate;
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+		{
+			// --- same rounding as SimpleDelay; the power of two makes the wrap a mask
+			unsigned int length = (unsigned int)(maxDelay_mSec[i] * (sampleRate / 1000.0)) + 1;
+			length = (unsigned int)(pow(2, ceil(log(length) / log(2))));
+
+			if (length > bufferCapacity[i])
+			{
+				delayLine[i].reset(new double[length + INPUT_DIFFUSER_CHUNK]);
+				bufferCapacity[i] = length;
+			}
+			bufferLength[i] = length;
+			wrapMask[i] = length - 1;
+		}
+		calculateDelays();
+		flushDelays();
+	}
+
+	/** clear the delay lines without re-allocating; safe to call from the audio thread */
+	void flushDelays()
+	{
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+		{
+			if (delayLine[i])
+				memset(&delayLine[i][0], 0, (bufferLength[i] + INPUT_DIFFUSER_CHUNK) * sizeof(double));
+			writeIndex[i] = 0;
+		}
+	}
+
 	/** return false: this object only processes samples */
 	virtual bool canProcessAudioFrame() { return false; }
 
-	/** process a single input through the two filters in series */
+	/** get parameters: note use of custom structure for passing param data */
 	/**
-	\param xn input
-	\return the processed sample
+	\return InputDiffuserParameters custom data structure
 	*/
-	virtual double processAudioSample(double xn)
-	{
-		// --- all modes do Full Wave Rectification
-		double filteredSignal = lowShelfFilter.processAudioSample(xn);
-		filteredSignal = highShelfFilter.processAudioSample(filteredSignal);
+	InputDiffuserParameters getParameters() { return parameters; }
 
-		return filteredSignal;
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param InputDiffuserParameters custom data structure
+	*/
+	void setParameters(const InputDiffuserParameters& params)
+	{
+		parameters = params;
+		calculateDelays();
 	}
 
-	/** get parameters: note use of custom structure for passing param data */
+	/** process one sample through every stage */
 	/**
-	\return TwoBandShelvingFilterParameters custom data structure
+	\param xn input
+	\return the processed sample
 	*/
-	TwoBandShelvingFilterParameters getParameters()
+	virtual double processAudioSample(double xn)
 	{
-		return parameters;
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+		{
+			if (delaySamples[i] == 0 || !delayLine[i])
+				continue;
+
+			double* buffer = &delayLine[i][0];
+			const unsigned int w = writeIndex[i];
+			const double g = parameters.apf_g[i];
+
+			// --- w(n-D), then w(n) = x(n) + gw(n-D) and y(n) = -gw(n) + w(n-D)
+			double wnD = buffer[(w - 1 - delaySamples[i]) & wrapMask[i]];
+			double wn = xn + g*wnD;
+			xn = -g*wn + wnD;
+
+			buffer[w] = wn;
+			if (w < INPUT_DIFFUSER_CHUNK)
+				buffer[bufferLength[i] + w] = wn;
+			writeIndex[i] = (w + 1) & wrapMask[i];
+		}
+		return xn;
 	}
 
-	/** set parameters: note use of custom structure for passing param data */
+	/** process a block in place, one stage at a time; same output as processAudioSample( ) on each sample */
 	/**
-	\param TwoBandShelvingFilterParameters custom data structure
+	\param buffer the samples to process
+	\param numSamples the block length
 	*/
-	void setParameters(const TwoBandShelvingFilterParameters& params)
+	void processAudioBlock(double* buffer, unsigned int numSamples)
 	{
-		parameters = params;
-		AudioFilterParameters filterParams = lowShelfFilter.getParameters();
-		filterParams.fc = parameters.lowShelf_fc;
-		filterParams.boostCut_dB = parameters.lowShelfBoostCut_dB;
-		lowShelfFilter.setParameters(filterParams);
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+		{
+			if (delaySamples[i] == 0 || !delayLine[i])
+				continue;
+
+			double* line = &delayLine[i][0];
+			const unsigned int D = delaySamples[i];
+			const unsigned int length = bufferLength[i];
+			const unsigned int mask = wrapMask[i];
+			const unsigned int maxRun = D + 1 < INPUT_DIFFUSER_CHUNK ? D + 1 : INPUT_DIFFUSER_CHUNK;
+			const double g = parameters.apf_g[i];
+
+			unsigned int start = 0;
+			while (start < numSamples)
+			{
+				// --- a run stops at the end of the line, so its writes never wrap
+				const unsigned int w = writeIndex[i];
+				unsigned int run = numSamples - start < maxRun ? numSamples - start : maxRun;
+				run = length - w < run ? length - w : run;
+
+				// --- w(n-D) for the whole run was written before it started (run <= D + 1) and is contiguous thanks to
+				//     the mirror, so the reads never overlap the writes
+				const double* wnD = line + ((w - 1 - D) & mask);
+				double* wn = line + w;
+				double* io = buffer + start;
+				for (unsigned int n = 0; n < run; n++)
+				{
+					double delayed = wnD[n];
+					double w_n = io[n] + g*delayed;
+					wn[n] = w_n;
+					io[n] = -g*w_n + delayed;
+				}
 
-		filterParams = highShelfFilter.getParameters();
-		filterParams.fc = parameters.highShelf_fc;
-		filterParams.boostCut_dB = parameters.highShelfBoostCut_dB;
-		highShelfFilter.setParameters(filterParams);
+				// --- keep the mirror of the line's start current
+				for (unsigned int n = w; n < w + run && n < INPUT_DIFFUSER_CHUNK; n++)
+					line[length + n] = line[n];
+
+				start += run;
+				writeIndex[i] = (w + run) & mask;
+			}
+		}
+	}
+
+	/** total delay of all stages in mSec */
+	double getTotalDelay_mSec()
+	{
+		double total = 0.0;
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+			total += parameters.delayTime_mSec[i];
+		return total;
 	}
 
 private:
-	TwoBandShelvingFilterParameters parameters; ///< object parameters
-	AudioFilter lowShelfFilter;					///< filter for low shelf
-	AudioFilter highShelfFilter;				///< filter for high shelf
-};
+	/** delay times in samples; truncated like an un-interpolated SimpleDelay read */
+	void calculateDelays()
+	{
+		for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+		{
+			double delay = parameters.delayTime_mSec[i] * (sampleRate / 1000.0);
+			delaySamples[i] = delay > 0.0 ? (unsigned int)delay : 0;
 
-/**
-\enum reverbDensity
-\ingroup Constants-Enums
-\brief
-Use this strongly typed enum to easily set the density in the reverb object.
+			// --- keep at least one sample of history
+			if (bufferLength[i] > 0 && delaySamples[i] >= bufferLength[i])
+				delaySamples[i] = bufferLength[i] - 1;
+		}
+	}
 
-- enum class reverbDensity { kThick, kSparse };
+	InputDiffuserParameters parameters;		///< object parameters
+	double sampleRate = 0.0;				///< current sample rate
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
-*/
-enum class reverbDensity { kThick, kSparse };
+	std::unique_ptr<double[]> delayLine[INPUT_DIFFUSER_STAGES];		///< per stage: bufferLength samples + INPUT_DIFFUSER_CHUNK mirror
+	unsigned int bufferCapacity[INPUT_DIFFUSER_STAGES] = { 0 };		///< allocated lengths (without the mirror)
+	unsigned int bufferLength[INPUT_DIFFUSER_STAGES] = { 0 };		///< lengths in use, powers of two
+	unsigned int wrapMask[INPUT_DIFFUSER_STAGES] = { 0 };			///< bufferLength - 1
+	unsigned int writeIndex[INPUT_DIFFUSER_STAGES] = { 0 };			///< next write position
+	unsigned int delaySamples[INPUT_DIFFUSER_STAGES] = { 0 };		///< integer delay D per stage
+};
+
+// --- lane count of the stereo lane objects (StereoLaneDelay, StereoLaneDelayAPF, StereoLaneFilter)
+const unsigned int NUM_STEREO_LANES = 2;
 
 /**
-\struct ReverbTankParameters
+\class StereoLaneDelay
 \ingroup FX-Objects
 \brief
-Custom parameter structure for the ReverbTank object.
+The StereoLaneDelay object implements two SimpleDelays that share one delay time, packed into one interleaved
+buffer: both lanes of a sample sit next to each other, so one read or write moves both and the index, wrap and
+interpolation weights are calculated once.
 
-\author Will Pirkle http://www.willpirkle.com
-\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
-\version Revision : 1.0
-\date Date : 2018 / 09 / 7
+Audio I/O:
+- Processes two lanes (two independent mono signals) in and out; each lane gives the same output as a SimpleDelay
+  with the same parameters.
+
+Control I/F:
+- Use SimpleDelayParameters structure to get/set object params.
 */
-struct ReverbTankParameters
+class StereoLaneDelay
 {
-	ReverbTankParameters() {}
-	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
-	ReverbTankParameters& operator=(const ReverbTankParameters& params)	// need this override for collections to work
+public:
+	StereoLaneDelay(void) {}	/* C-TOR */
+	~StereoLaneDelay(void) {}	/* D-TOR */
+
+	/** create the delay buffer; memory is only allocated if the buffer has to grow, so create the largest one first */
+	/**
+	\param _sampleRate the sample rate
+	\param _bufferLength_mSec the longest delay or read
+	*/
+	void createDelayBuffer(double _sampleRate, double _bufferLength_mSec)
 	{
-		if (this == &params)
-			return *this;
+		bufferLength_mSec = _bufferLength_mSec;
+		sampleRate = _sampleRate;
+		samplesPerMSec = sampleRate / 1000.0;
 
-		density = params.density;
+		// --- same length as the SimpleDelay CircularBuffer: +1 for the fractional part, then a power of 2
+		unsigned int length = (unsigned int)(bufferLength_mSec*(samplesPerMSec)) + 1;
+		length = (unsigned int)(pow(2, ceil(log(length) / log(2))));
 
-		// --- tweaker variables
-		apfDelayMax_mSec = params.apfDelayMax_mSec;
-		apfDelayWeight_Pct = params.apfDelayWeight_Pct;
-		fixeDelayMax_mSec = params.fixeDelayMax_mSec;
-		fixeDelayWeight_Pct = params.fixeDelayWeight_Pct;
-		preDelayTime_mSec = params.preDelayTime_mSec;
+		if (length > bufferCapacity)
+		{
+			buffer.reset(new double[length * NUM_STEREO_LANES]);
+			bufferCapacity = length;
+		}
+		bufferLength = length;
+		wrapMask = length - 1;
+		writeIndex = 0;
+		flushDelay();
+	}
 
-		lpf_g = params.lpf_g;
-		kRT = params.kRT;
+	/** clear the delay line without re-allocating; safe to call from the audio thread */
+	void flushDelay()
+	{
+		if (buffer)
+			memset(&buffer[0], 0, bufferLength * NUM_STEREO_LANES * sizeof(double));
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return SimpleDelayParameters custom data structure
+	*/
+	SimpleDelayParameters getParameters() { return simpleDelayParameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param SimpleDelayParameters custom data structure
+	*/
+	void setParameters(const SimpleDelayParameters& params)
+	{
+		simpleDelayParameters = params;
+		simpleDelayParameters.delay_Samples = simpleDelayParameters.delayTime_mSec*(samplesPerMSec);
+	}
+
+	/** process both lanes; a zero delay passes the input through */
+	/**
+	\param xn NUM_STEREO_LANES inputs
+	\param yn NUM_STEREO_LANES outputs (may be the same array as xn)
+	*/
+	void processAudioLanes(const double* xn, double* yn)
+	{
+		if (simpleDelayParameters.delay_Samples == 0)
+		{
+			yn[0] = xn[0];
+			yn[1] = xn[1];
+			return;
+		}
+
+		double delayed[NUM_STEREO_LANES];
+		readBuffer(simpleDelayParameters.delay_Samples, delayed);
+		writeDelay(xn);
+		yn[0] = delayed[0];
+		yn[1] = delayed[1];
+	}
+
+	/** read both lanes at the current delay time */
+	void readDelay(double* yn) { readBuffer(simpleDelayParameters.delay_Samples, yn); }
+
+	/** read both lanes at an arbitrary delay time */
+	void readDelayAtTime_mSec(double _delay_mSec, double* yn) { readBuffer(_delay_mSec*(samplesPerMSec), yn); }
+
+	/** read one lane at an arbitrary delay time (output taps) */
+	double readLaneAtTime_mSec(double _delay_mSec, unsigned int lane)
+	{
+		double yn[NUM_STEREO_LANES];
+		readBuffer(_delay_mSec*(samplesPerMSec), yn);
+		return yn[lane];
+	}
+
+	/** write both lanes */
+	void writeDelay(const double* xn)
+	{
+		double* frame = &buffer[writeIndex * NUM_STEREO_LANES];
+		frame[0] = xn[0];
+		frame[1] = xn[1];
+		writeIndex = (writeIndex + 1) & wrapMask;
+	}
+
+private:
+	/** read both lanes delayInSamples old; read-before-write, like CircularBuffer */
+	inline const double* readFrame(int delayInSamples)
+	{
+		unsigned int readIndex = (writeIndex - 1 - delayInSamples) & wrapMask;
+		return &buffer[readIndex * NUM_STEREO_LANES];
+	}
+
+	/** fractional read with the same truncation and interpolators as CircularBuffer::readBuffer( ) */
+	void readBuffer(double delayInFractionalSamples, double* yn)
+	{
+		int delay = (int)delayInFractionalSamples;
+		const double* y1 = readFrame(delay);
+		if (!simpleDelayParameters.interpolate)
+		{
+			yn[0] = y1[0];
+			yn[1] = y1[1];
+			return;
+		}
+
+		const double* y2 = readFrame(delay + 1);
+		double fraction = delayInFractionalSamples - delay;
+		if (simpleDelayParameters.interpolationType == interpolation::kLagrange4 && delayInFractionalSamples >= 1.0)
+		{
+			const double* y0 = readFrame(delay - 1);
+			const double* y3 = readFrame(delay + 2);
+			for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+				yn[i] = doLagrange4Interpolation(y0[i], y1[i], y2[i], y3[i], fraction);
+			return;
+		}
+		for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+			yn[i] = doLinearInterpolation(y1[i], y2[i], fraction);
+	}
+
+	SimpleDelayParameters simpleDelayParameters; ///< object parameters
+
+	double sampleRate = 0.0;		///< sample rate
+	double samplesPerMSec = 0.0;	///< samples per millisecond (for arbitrary access)
+	double bufferLength_mSec = 0.0; ///< total buffer lenth in mSec
+
+	std::unique_ptr<double[]> buffer = nullptr;	///< interleaved lanes, NUM_STEREO_LANES doubles per sample
+	unsigned int bufferLength = 0;		///< length in samples, a power of 2
+	unsigned int bufferCapacity = 0;	///< allocated length in samples
+	unsigned int wrapMask = 0;			///< bufferLength - 1
+	unsigned int writeIndex = 0;		///< next write position
+};
+
+/**
+\class StereoLaneDelayAPF
+\ingroup FX-Objects
+\brief
+The StereoLaneDelayAPF object implements two DelayAPFs that share one set of parameters and one LFO, on a
+StereoLaneDelay: the parameter fetch, the LFO and the modulated read index are done once for both lanes.
+
+Audio I/O:
+- Processes two lanes in and out; each lane gives the same output as a DelayAPF with the same parameters.
+
+Control I/F:
+- Use DelayAPFParameters structure to get/set object params.
+*/
+class StereoLaneDelayAPF
+{
+public:
+	StereoLaneDelayAPF(void) {}		/* C-TOR */
+	~StereoLaneDelayAPF(void) {}	/* D-TOR */
+
+	/** reset members to initialized state */
+	bool reset(double _sampleRate)
+	{
+		// --- reset children
+		modLFO.reset(_sampleRate);
+
+		// --- flush
+		lpf_state[0] = lpf_state[1] = 0.0;
+
+		// --- re-create the buffer, will store sample rate and length(mSec)
+		createDelayBuffer(sampleRate, bufferLength_mSec);
+
+		return true;
+	}
+
+	/** process both lanes */
+	/**
+	\param xn NUM_STEREO_LANES inputs
+	\param yn NUM_STEREO_LANES outputs (may be the same array as xn)
+	*/
+	void processAudioLanes(const double* xn, double* yn)
+	{
+		if (delaySamples == 0)
+		{
+			yn[0] = xn[0];
+			yn[1] = xn[1];
+			return;
+		}
+
+		// --- delay line output
+		double wnD[NUM_STEREO_LANES];
+		double apf_g = delayAPFParameters.apf_g;
+		double lpf_g = delayAPFParameters.lpf_g;
+
+		// --- for modulated APFs: one LFO value and one read position for both lanes
+		if (delayAPFParameters.enableLFO)
+		{
+			SignalGenData lfoOutput = modLFO.renderAudioOutput();
+			double maxDelay = delayAPFParameters.delayTime_mSec;
+			double minDelay = maxDelay - delayAPFParameters.lfoMaxModulation_mSec;
+			minDelay = fmax(0.0, minDelay); // bound minDelay to 0 as minimum
+
+			double modDelay_mSec = doUnipolarModulationFromMax(bipolarToUnipolar(delayAPFParameters.lfoDepth*lfoOutput.normalOutput),
+				minDelay, maxDelay);
+
+			delay.readDelayAtTime_mSec(modDelay_mSec, wnD);
+		}
+		else
+			delay.readDelay(wnD);
+
+		double wn[NUM_STEREO_LANES];
+		for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+		{
+			if (delayAPFParameters.enableLPF)
+			{
+				// --- apply simple 1st order pole LPF, overwrite wnD
+				wnD[i] = wnD[i]*(1.0 - lpf_g) + lpf_g*lpf_state[i];
+				lpf_state[i] = wnD[i];
+			}
+
+			// --- form w(n) = x(n) + gw(n-D) and y(n) = -gw(n) + w(n-D)
+			wn[i] = xn[i] + apf_g*wnD[i];
+			yn[i] = -apf_g*wn[i] + wnD[i];
+		}
+
+		// --- write delay line
+		delay.writeDelay(wn);
+	}
+
+	/** read one lane of the delay line at an arbitrary time (output taps) */
+	double readDelay(double delayTime, unsigned int lane) { return delay.readLaneAtTime_mSec(delayTime, lane); }
+
+	/** clear the delay line and LPF state without re-allocating; safe to call from the audio thread */
+	void flushDelay()
+	{
+		delay.flushDelay();
+		lpf_state[0] = lpf_state[1] = 0.0;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return DelayAPFParameters custom data structure
+	*/
+	DelayAPFParameters getParameters() { return delayAPFParameters; }
+
+	/** set parameters: note use of custom structure for passing param data; as with DelayAPF, the LFO keeps its own
+	    OscillatorParameters */
+	/**
+	\param DelayAPFParameters custom data structure
+	*/
+	void setParameters(const DelayAPFParameters& params)
+	{
+		delayAPFParameters = params;
+
+		// --- update delay line
+		SimpleDelayParameters delayParams = delay.getParameters();
+		delayParams.delayTime_mSec = delayAPFParameters.delayTime_mSec;
+		delayParams.interpolate = delayAPFParameters.interpolate;
+		delayParams.interpolationType = delayAPFParameters.interpolationType;
+		delay.setParameters(delayParams);
+		delaySamples = delay.getParameters().delay_Samples;
+	}
+
+	/** create the delay buffer in mSec */
+	void createDelayBuffer(double _sampleRate, double delay_mSec)
+	{
+		sampleRate = _sampleRate;
+		bufferLength_mSec = delay_mSec;
+		delay.createDelayBuffer(_sampleRate, delay_mSec);
+	}
+
+protected:
+	DelayAPFParameters delayAPFParameters;	///< obeject parameters
+	double sampleRate = 0.0;				///< current sample rate
+	double bufferLength_mSec = 0.0;			///< total buffer length in mSec
+	double delaySamples = 0.0;				///< delay in samples, cached from the delay line
+
+	StereoLaneDelay delay;					///< both lanes' delay lines
+	LFO modLFO;								///< LFO, shared by both lanes
+	double lpf_state[NUM_STEREO_LANES] = { 0.0, 0.0 };	///< LPF state registers (z^-1)
+};
+
+/**
+\class StereoLaneFilter
+\ingroup FX-Objects
+\brief
+The StereoLaneFilter object is an AudioFilter that can also run two lanes with their own states and the shared
+coefficients; the lanes use the transposed canonical biquad (the AudioFilter default) and give the same output
+as an AudioFilter with the same parameters.
+
+Audio I/O:
+- Processes mono input to mono output, or two lanes in and out with processAudioLanes( ).
+
+Control I/F:
+- Use AudioFilterParameters structure to get/set object params.
+*/
+class StereoLaneFilter : public AudioFilter
+{
+public:
+	StereoLaneFilter() {}		/* C-TOR */
+	~StereoLaneFilter() {}		/* D-TOR */
+
+	/** set sample rate, clear the lane states */
+	virtual bool reset(double _sampleRate)
+	{
+		memset(laneState, 0, sizeof(laneState));
+		return AudioFilter::reset(_sampleRate);
+	}
+
+	/** process both lanes */
+	/**
+	\param xn NUM_STEREO_LANES inputs
+	\param yn NUM_STEREO_LANES outputs (may be the same array as xn)
+	*/
+	void processAudioLanes(const double* xn, double* yn)
+	{
+		for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+		{
+			double x = xn[i];
+
+			// --- transposed canonical biquad, then the dry/processed mix: x(n)*d0 + y(n)*c0
+			double biquadOut = coeffArray[a0] * x + laneState[i][0];
+			laneState[i][0] = coeffArray[a1] * x - coeffArray[b1] * biquadOut + laneState[i][1];
+			laneState[i][1] = coeffArray[a2] * x - coeffArray[b2] * biquadOut;
+
+			yn[i] = coeffArray[d0] * x + coeffArray[c0] * biquadOut;
+		}
+	}
+
+private:
+	double laneState[NUM_STEREO_LANES][2] = { { 0.0, 0.0 }, { 0.0, 0.0 } };	///< per lane z^-1 and z^-2 registers
+};
+
+/**
+\struct TwoBandShelvingFilterParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the TwoBandShelvingFilter object. Used for reverb algorithms in book.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct TwoBandShelvingFilterParameters
+{
+	TwoBandShelvingFilterParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	TwoBandShelvingFilterParameters& operator=(const TwoBandShelvingFilterParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		lowShelf_fc = params.lowShelf_fc;
+		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
+		highShelf_fc = params.highShelf_fc;
+		highShelfBoostCut_dB = params.highShelfBoostCut_dB;
+		return *this;
+	}
+
+	// --- individual parameters
+	double lowShelf_fc = 0.0;			///< fc for low shelf
+	double lowShelfBoostCut_dB = 0.0;	///< low shelf gain
+	double highShelf_fc = 0.0;			///< fc for high shelf
+	double highShelfBoostCut_dB = 0.0;	///< high shelf gain
+};
+
+/**
+\class TwoBandShelvingFilter
+\ingroup FX-Objects
+\brief
+The TwoBandShelvingFilter object implements two shelving filters in series in the standard "Bass and Treble" configuration.
+
+Audio I/O:
+- Processes mono input to mono output.
+
+Control I/F:
+- Use TwoBandShelvingFilterParameters structure to get/set object params.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+class TwoBandShelvingFilter : public IAudioSignalProcessor
+{
+public:
+	TwoBandShelvingFilter()
+	{
+		AudioFilterParameters params = lowShelfFilter.getParameters();
+		params.algorithm = filterAlgorithm::kLowShelf;
+		lowShelfFilter.setParameters(params);
+
+		params = highShelfFilter.getParameters();
+		params.algorithm = filterAlgorithm::kHiShelf;
+		highShelfFilter.setParameters(params);
+	}		/* C-TOR */
+
+	~TwoBandShelvingFilter() {}		/* D-TOR */
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		lowShelfFilter.reset(_sampleRate);
+		highShelfFilter.reset(_sampleRate);
+		return true;
+	}
+
+	/** return false: this object only processes samples */
+	virtual bool canProcessAudioFrame() { return false; }
+
+	/** process a single input through the two filters in series */
+	/**
+	\param xn input
+	\return the processed sample
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		// --- all modes do Full Wave Rectification
+		double filteredSignal = lowShelfFilter.processAudioSample(xn);
+		filteredSignal = highShelfFilter.processAudioSample(filteredSignal);
+
+		return filteredSignal;
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return TwoBandShelvingFilterParameters custom data structure
+	*/
+	TwoBandShelvingFilterParameters getParameters()
+	{
+		return parameters;
+	}
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param TwoBandShelvingFilterParameters custom data structure
+	*/
+	void setParameters(const TwoBandShelvingFilterParameters& params)
+	{
+		parameters = params;
+		AudioFilterParameters filterParams = lowShelfFilter.getParameters();
+		filterParams.fc = parameters.lowShelf_fc;
+		filterParams.boostCut_dB = parameters.lowShelfBoostCut_dB;
+		lowShelfFilter.setParameters(filterParams);
+
+		filterParams = highShelfFilter.getParameters();
+		filterParams.fc = parameters.highShelf_fc;
+		filterParams.boostCut_dB = parameters.highShelfBoostCut_dB;
+		highShelfFilter.setParameters(filterParams);
+	}
+
+private:
+	TwoBandShelvingFilterParameters parameters; ///< object parameters
+	AudioFilter lowShelfFilter;					///< filter for low shelf
+	AudioFilter highShelfFilter;				///< filter for high shelf
+};
+
+/**
+\enum reverbDensity
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to easily set the density in the reverb object.
+
+- enum class reverbDensity { kThick, kSparse };
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+enum class reverbDensity { kThick, kSparse };
+
+/**
+\struct ReverbTankParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the ReverbTank object.
+
+\author Will Pirkle http://www.willpirkle.com
+\remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
+\version Revision : 1.0
+\date Date : 2018 / 09 / 7
+*/
+struct ReverbTankParameters
+{
+	ReverbTankParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	ReverbTankParameters& operator=(const ReverbTankParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		density = params.density;
+
+		// --- tweaker variables
+		apfDelayMax_mSec = params.apfDelayMax_mSec;
+		apfDelayWeight_Pct = params.apfDelayWeight_Pct;
+		fixeDelayMax_mSec = params.fixeDelayMax_mSec;
+		fixeDelayWeight_Pct = params.fixeDelayWeight_Pct;
+		preDelayTime_mSec = params.preDelayTime_mSec;
+
+		lpf_g = params.lpf_g;
+		kRT = params.kRT;
 
 		lowShelf_fc = params.lowShelf_fc;
 		lowShelfBoostCut_dB = params.lowShelfBoostCut_dB;
@@ -4995,6 +5842,521 @@ private:
 };
 
 
+/**
+\enum fdnMixingMatrix
+\ingroup Constants-Enums
+\brief
+Use this strongly typed enum to set the feedback matrix of the FDNReverb object.
+
+- enum class fdnMixingMatrix { kHadamard, kHouseholder };
+*/
+enum class fdnMixingMatrix { kHadamard, kHouseholder };
+
+// --- constants for FDN reverb
+const unsigned int FDN_MAX_LINES = 32;			///< largest network; line counts are powers of two up to this
+const double kFDNGoldenRatio = 0.6180339887;	///< fractional part of the golden ratio, for the delay time jitter
+
+/**
+\struct FDNReverbParameters
+\ingroup FX-Objects
+\brief
+Custom parameter structure for the FDNReverb object.
+*/
+struct FDNReverbParameters
+{
+	FDNReverbParameters() {}
+	/** all FXObjects parameter objects require overloaded= operator so remember to add new entries if you add new variables. */
+	FDNReverbParameters& operator=(const FDNReverbParameters& params)	// need this override for collections to work
+	{
+		if (this == &params)
+			return *this;
+
+		numLines = params.numLines;
+		mixingMatrix = params.mixingMatrix;
+		minDelay_mSec = params.minDelay_mSec;
+		maxDelay_mSec = params.maxDelay_mSec;
+		RT60Time_mSec = params.RT60Time_mSec;
+		damping_fc = params.damping_fc;
+		return *this;
+	}
+
+	// --- individual parameters
+	unsigned int numLines = 16;									///< number of delay lines: 2, 4, 8, 16 or 32 (rounded up to a power of two)
+	fdnMixingMatrix mixingMatrix = fdnMixingMatrix::kHadamard;	///< feedback matrix
+	double minDelay_mSec = 20.0;								///< shortest delay line
+	double maxDelay_mSec = 80.0;								///< longest delay line; must fit in the buffers from createDelayBuffers( )
+	double RT60Time_mSec = 2000.0;								///< reverb time (-60dB)
+	double damping_fc = 10000.0;								///< fc of the one-pole LPF in each line
+};
+
+/**
+\class FDNReverb
+\ingroup FX-Objects
+\brief
+The FDNReverb object implements a feedback delay network: N delay lines, each with a one-pole damping LPF
+and an RT60 gain, mixed back into each other through an orthogonal matrix.
+
+Audio I/O:
+- Processes mono input to mono OR stereo output; stereo input feeds the even (left) and odd (right) lines.
+
+Control I/F:
+- Use FDNReverbParameters structure to get/set object params.
+
+Operation:
+- delay times are spread geometrically between minDelay_mSec and maxDelay_mSec with a golden-ratio jitter and
+  rounded to odd sample counts, so the lines share as few common factors as possible
+- each line has gain 10^(-3*delay/RT60) so every path decays at the same rate
+- the Hadamard matrix is applied with the fast Walsh-Hadamard transform (N log2 N adds, no multiplies until the
+  final 1/sqrt(N)); the Householder matrix I - 2/N is a sum and a subtract per line; both are plain loops over
+  contiguous arrays that the compiler can vectorize
+- call createDelayBuffers( ) once (from initialize) with the highest sample rate; reset( ) and setParameters( )
+  only re-use that memory
+*/
+class FDNReverb : public IAudioSignalProcessor
+{
+public:
+	FDNReverb() {}		/* C-TOR */
+	~FDNReverb() {}		/* D-TOR */
+
+	/** reset members to initialized state */
+	virtual bool reset(double _sampleRate)
+	{
+		sampleRate = _sampleRate;
+
+		for (unsigned int i = 0; i < FDN_MAX_LINES; i++)
+		{
+			delayLines[i].reset(_sampleRate);
+			dampingLPFs[i].reset(_sampleRate);
+		}
+
+		// --- delay times and coefficients depend on the sample rate
+		calculateNetwork();
+		return true;
+	}
+
+	/** create the delay buffers for all FDN_MAX_LINES lines */
+	/**
+	\param _sampleRate the highest sample rate the object will run at
+	\param _maxDelay_mSec the longest maxDelay_mSec that will be used
+	*/
+	void createDelayBuffers(double _sampleRate, double _maxDelay_mSec)
+	{
+		for (unsigned int i = 0; i < FDN_MAX_LINES; i++)
+			delayLines[i].createDelayBuffer(_sampleRate, _maxDelay_mSec);
+	}
+
+	/** choose the sample storage of every line (see bufferStorage); call before createDelayBuffers( ) */
+	void setStorageType(bufferStorage type)
+	{
+		for (unsigned int i = 0; i < FDN_MAX_LINES; i++)
+			delayLines[i].setStorageType(type);
+	}
+
+	/** clear all delay lines and filter states without re-allocating; safe to call from the audio thread */
+	void flushDelays()
+	{
+		for (unsigned int i = 0; i < FDN_MAX_LINES; i++)
+		{
+			delayLines[i].flushDelay();
+			dampingLPFs[i].reset(sampleRate);
+		}
+	}
+
+	/** return true: this object can process frames */
+	virtual bool canProcessAudioFrame() { return true; }
+
+	/** process mono FDN */
+	/**
+	\param xn input
+	\return the processed sample (left output)
+	*/
+	virtual double processAudioSample(double xn)
+	{
+		double yL = 0.0;
+		double yR = 0.0;
+		processFDN(xn, xn, yL, yR);
+		return yL;
+	}
+
+	/** process stereo FDN; output is wet only */
+	virtual bool processAudioFrame(const float* inputFrame,
+		float* outputFrame,
+		uint32_t inputChannels,
+		uint32_t outputChannels)
+	{
+		double xnL = inputFrame[0];
+		double xnR = inputChannels > 1 ? inputFrame[1] : xnL;
+		double yL = 0.0;
+		double yR = 0.0;
+		processFDN(xnL, xnR, yL, yR);
+
+		if (outputChannels == 1)
+			outputFrame[0] = 0.5*yL + 0.5*yR;
+		else
+		{
+			outputFrame[0] = yL;
+			outputFrame[1] = yR;
+		}
+		return true;
+	}
+
+	/** one sample through the network */
+	/**
+	\param xnL left input, feeds the even lines
+	\param xnR right input, feeds the odd lines
+	\param yL left output, tapped from the even lines
+	\param yR right output, tapped from the odd lines
+	*/
+	void processFDN(double xnL, double xnR, double& yL, double& yR)
+	{
+		double yn[2] = { 0.0, 0.0 };
+		processFDN(xnL, xnR, yn, 2);
+		yL = yn[0];
+		yR = yn[1];
+	}
+
+	/** one sample through the network with any number of outputs (surround); output k is tapped from lines
+	    k, k + numOutputs, k + 2*numOutputs... so the outputs share no lines and are decorrelated */
+	/**
+	\param xnL left input, feeds the even lines
+	\param xnR right input, feeds the odd lines
+	\param yn numOutputs outputs; 2 gives the same output as processFDN(xnL, xnR, yL, yR)
+	\param numOutputs number of outputs, no more than the line count
+	*/
+	void processFDN(double xnL, double xnR, double* yn, unsigned int numOutputs)
+	{
+		const unsigned int N = numLines;
+		double lineOut[FDN_MAX_LINES];
+
+		// --- read, damp and attenuate each line
+		for (unsigned int k = 0; k < numOutputs; k++)
+			yn[k] = 0.0;
+		unsigned int output = 0;
+		for (unsigned int i = 0; i < N; i++)
+		{
+			lineOut[i] = feedbackGain[i] * dampingLPFs[i].processAudioSample(delayLines[i].readDelay());
+			yn[output] += outputSign[i] * lineOut[i];
+			if (++output == numOutputs)
+				output = 0;
+		}
+
+		// --- same output normalization as the stereo taps: 1/sqrt(lines per output)
+		double outputScale = numOutputs == 2 ? ioScale : 1.0 / sqrt(fmax((double)N / numOutputs, 1.0));
+		for (unsigned int k = 0; k < numOutputs; k++)
+			yn[k] *= outputScale;
+
+		// --- feedback matrix, in place
+		if (parameters.mixingMatrix == fdnMixingMatrix::kHadamard)
+			fastWalshHadamard(lineOut, N);
+		else
+			householder(lineOut, N);
+
+		// --- inject input and write back; tiny DC keeps the tail out of denormal range
+		for (unsigned int i = 0; i < N; i++)
+		{
+			double xn = (i & 1) ? xnR : xnL;
+			delayLines[i].writeDelay(lineOut[i] + ioScale*inputSign[i] * xn + kAntiDenormalOffset);
+		}
+	}
+
+	/** get parameters: note use of custom structure for passing param data */
+	/**
+	\return FDNReverbParameters custom data structure
+	*/
+	FDNReverbParameters getParameters() { return parameters; }
+
+	/** set parameters: note use of custom structure for passing param data */
+	/**
+	\param FDNReverbParameters custom data structure
+	*/
+	void setParameters(const FDNReverbParameters& params)
+	{
+		// --- round the line count up to a power of two for the Hadamard transform
+		unsigned int lines = 2;
+		while (lines < params.numLines && lines < FDN_MAX_LINES)
+			lines *= 2;
+
+		// --- only recalculate on a real change (this can be called once per sample)
+		if (lines == numLines &&
+			params.mixingMatrix == parameters.mixingMatrix &&
+			params.minDelay_mSec == parameters.minDelay_mSec &&
+			params.maxDelay_mSec == parameters.maxDelay_mSec &&
+			params.RT60Time_mSec == parameters.RT60Time_mSec &&
+			params.damping_fc == parameters.damping_fc)
+			return;
+
+		// --- lines that are switched on start from silence, not from whatever they held last time
+		for (unsigned int i = numLines; i < lines; i++)
+		{
+			delayLines[i].flushDelay();
+			dampingLPFs[i].reset(sampleRate);
+		}
+
+		parameters = params;
+		parameters.numLines = lines;
+		numLines = lines;
+		calculateNetwork();
+	}
+
+protected:
+	/** delay times, feedback gains and damping coefficients from the parameters */
+	void calculateNetwork()
+	{
+		if (sampleRate <= 0.0)
+			return;
+
+		double samplesPerMSec = sampleRate / 1000.0;
+		double minDelay_mSec = fmax(parameters.minDelay_mSec, 1.0);
+		double maxDelay_mSec = fmax(parameters.maxDelay_mSec, minDelay_mSec);
+		double rt60_mSec = fmax(parameters.RT60Time_mSec, 1.0);
+
+		SimpleLPFParameters lpfParams = dampingLPFs[0].getParameters();
+		lpfParams.g = exp(-2.0*kPi*parameters.damping_fc / sampleRate);
+
+		SimpleDelayParameters delayParams = delayLines[0].getParameters();
+
+		for (unsigned int i = 0; i < numLines; i++)
+		{
+			// --- geometric spread with golden-ratio jitter
+			double spread = numLines > 1 ? (double)i / (double)(numLines - 1) : 0.0;
+			double jitter = fmod((i + 1)*kFDNGoldenRatio, 1.0) - 0.5;
+			double delay_mSec = minDelay_mSec*pow(maxDelay_mSec / minDelay_mSec, spread)*(1.0 + 0.06*jitter);
+			delay_mSec = fmin(fmax(delay_mSec, minDelay_mSec), maxDelay_mSec);
+
+			// --- odd sample counts
+			unsigned int delay_Samples = (unsigned int)(delay_mSec*samplesPerMSec) | 1;
+
+			delayParams.delayTime_mSec = (delay_Samples + 0.5) / samplesPerMSec; // +0.5: truncated read lands on delay_Samples
+			delayLines[i].setParameters(delayParams);
+
+			feedbackGain[i] = pow(10.0, -3.0*(delay_Samples / samplesPerMSec) / rt60_mSec);
+			dampingLPFs[i].setParameters(lpfParams);
+		}
+
+		// --- energy preserving input and output spread over N/2 lines per channel
+		ioScale = 1.0 / sqrt(fmax(numLines / 2.0, 1.0));
+	}
+
+	/** normalized fast Walsh-Hadamard transform, in place; N must be a power of two */
+	static void fastWalshHadamard(double* x, unsigned int N)
+	{
+		for (unsigned int h = 1; h < N; h *= 2)
+		{
+			for (unsigned int i = 0; i < N; i += 2 * h)
+			{
+				for (unsigned int j = i; j < i + h; j++)
+				{
+					double a = x[j];
+					double b = x[j + h];
+					x[j] = a + b;
+					x[j + h] = a - b;
+				}
+			}
+		}
+
+		double scale = 1.0 / sqrt((double)N);
+		for (unsigned int i = 0; i < N; i++)
+			x[i] *= scale;
+	}
+
+	/** Householder reflection I - (2/N)11', in place */
+	static void householder(double* x, unsigned int N)
+	{
+		double sum = 0.0;
+		for (unsigned int i = 0; i < N; i++)
+			sum += x[i];
+
+		sum *= 2.0 / N;
+		for (unsigned int i = 0; i < N; i++)
+			x[i] -= sum;
+	}
+
+private:
+	FDNReverbParameters parameters;					///< object parameters
+
+	SimpleDelay delayLines[FDN_MAX_LINES];			///< the delay lines
+	SimpleLPF dampingLPFs[FDN_MAX_LINES];			///< one-pole damping in each line
+	double feedbackGain[FDN_MAX_LINES] = { 0.0 };	///< RT60 gain of each line
+
+	// --- fixed +/-1 patterns decorrelate the input taps and the L/R output sums
+	double inputSign[FDN_MAX_LINES] = {  1, 1, -1, 1, 1, -1, -1, 1, -1, 1, 1, -1, 1, -1, -1, -1,
+										 1, -1, 1, 1, -1, 1, -1, -1, 1, 1, -1, -1, -1, 1, 1, 1 };	///< input injection signs
+	double outputSign[FDN_MAX_LINES] = { 1, -1, -1, 1, 1, 1, -1, -1, 1, -1, 1, 1, -1, -1, 1, -1,
+										 -1, 1, 1, -1, -1, 1, 1, 1, -1, -1, -1, 1, 1, 1, -1, 1 };	///< output tap signs
+
+	unsigned int numLines = 16;		///< active line count (power of two)
+	double ioScale = 0.35355;		///< input/output normalization, 1/sqrt(N/2)
+	double sampleRate = 0.0;		///< current sample rate
+};
+
+
+// --- constants for half-band filter
+const unsigned int HALFBAND_MAX_COEFFICIENTS = 12;
+
+/**
+\class HalfBandFilter
+\ingroup FX-Objects
+\brief
+The HalfBandFilter object implements a 2:1 decimator or 1:2 interpolator using a polyphase IIR half-band filter:
+two parallel chains of first order allpass sections that run at the lower sample rate.
+
+Audio I/O:
+- decimateAudio( ): two input samples to one output sample
+- interpolateAudio( ): one input sample to two output samples
+- use one object per direction and channel; the object holds the filter state
+
+Control I/F:
+- initialize( ) with the number of allpass sections and the transition band width
+
+Operation:
+- the coefficients come from the elliptic half-band design (Valenzuela and Constantinides, as popularized by de Soras)
+- 8 sections with a 0.04 transition band are flat to 0.21 x the higher rate and reject more than 100dB above 0.29;
+  that is 8 multiplies per conversion, the cheapest way to get that stopband
+- the phase response is not linear, which does not matter inside a reverb
+*/
+class HalfBandFilter
+{
+public:
+	HalfBandFilter() {}		/* C-TOR */
+	~HalfBandFilter() {}	/* D-TOR */
+
+	/** design the allpass coefficients and clear the state */
+	/**
+	\param _numCoefficients number of first order allpass sections (both paths together), up to HALFBAND_MAX_COEFFICIENTS
+	\param transitionBand width of the transition band relative to the higher sample rate, 0 to 0.5;
+	       the passband ends at 0.25 - transitionBand
+	*/
+	void initialize(unsigned int _numCoefficients, double transitionBand)
+	{
+		numCoefficients = _numCoefficients < HALFBAND_MAX_COEFFICIENTS ? _numCoefficients : HALFBAND_MAX_COEFFICIENTS;
+
+		// --- elliptic half-band: transition parameter k and nome q
+		double k = tan((1.0 - transitionBand*2.0)*kPi / 4.0);
+		k *= k;
+		double kksqrt = pow(1.0 - k*k, 0.25);
+		double e = 0.5*(1.0 - kksqrt) / (1.0 + kksqrt);
+		double e4 = e*e*e*e;
+		double q = e*(1.0 + e4*(2.0 + e4*(15.0 + 150.0*e4)));
+
+		unsigned int order = numCoefficients * 2 + 1;
+		for (unsigned int i = 0; i < numCoefficients; i++)
+		{
+			double c = i + 1;
+
+			// --- theta function series
+			double num = 0.0;
+			double sign = 1.0;
+			for (unsigned int j = 0; j < 32; j++)
+			{
+				double term = pow(q, (double)(j*(j + 1)))*sin((j * 2 + 1)*c*kPi / order)*sign;
+				num += term;
+				sign = -sign;
+				if (fabs(term) < 1.0e-100) break;
+			}
+			num *= pow(q, 0.25);
+
+			double den = 0.5;
+			sign = -1.0;
+			for (unsigned int j = 1; j < 32; j++)
+			{
+				double term = pow(q, (double)(j*j))*cos(j * 2 * c*kPi / order)*sign;
+				den += term;
+				sign = -sign;
+				if (fabs(term) < 1.0e-100) break;
+			}
+
+			double ww = num / den;
+			double wwsq = ww*ww;
+			double x = sqrt((1.0 - wwsq*k)*(1.0 - wwsq / k)) / (1.0 + wwsq);
+			coefficients[i] = (1.0 - x) / (1.0 + x);
+		}
+		reset();
+	}
+
+	/** clear the allpass states */
+	void reset()
+	{
+		for (unsigned int i = 0; i < HALFBAND_MAX_COEFFICIENTS; i++)
+			xState[i] = yState[i] = 0.0;
+	}
+
+	/** two input samples at the higher rate to one output sample at half the rate */
+	/**
+	\param xn0 the older input sample
+	\param xn1 the newer input sample
+	\return the decimated sample
+	*/
+	double decimateAudio(double xn0, double xn1)
+	{
+		double path0 = xn1;
+		double path1 = xn0;
+		processPaths(path0, path1);
+		return 0.5*(path0 + path1);
+	}
+
+	/** one input sample to two output samples at twice the rate */
+	/**
+	\param xn the input sample
+	\param yn0 the first (older) output sample
+	\param yn1 the second output sample
+	*/
+	void interpolateAudio(double xn, double& yn0, double& yn1)
+	{
+		double path0 = xn;
+		double path1 = xn;
+		processPaths(path0, path1);
+		yn0 = path0;
+		yn1 = path1;
+	}
+
+	/** group delay at DC of one decimateAudio( ) or interpolateAudio( ) conversion */
+	/**
+	\return delay in samples at the higher rate: each section adds (1 - a)/(1 + a) lower rate samples to its path,
+	        the paths are averaged and path 1 is one higher rate sample behind path 0
+	*/
+	double getGroupDelay()
+	{
+		double delay = 0.5;
+		for (unsigned int i = 0; i < numCoefficients; i++)
+			delay += (1.0 - coefficients[i]) / (1.0 + coefficients[i]);
+		return delay;
+	}
+
+protected:
+	/** run the two allpass chains; even coefficients on path 0, odd on path 1; the chains are independent,
+	    so they are stepped side by side */
+	void processPaths(double& path0, double& path1)
+	{
+		unsigned int i = 0;
+		for (; i + 1 < numCoefficients; i += 2)
+		{
+			double yn0 = (path0 - yState[i])*coefficients[i] + xState[i];
+			double yn1 = (path1 - yState[i + 1])*coefficients[i + 1] + xState[i + 1];
+			xState[i] = path0;
+			xState[i + 1] = path1;
+			yState[i] = yn0;
+			yState[i + 1] = yn1;
+			path0 = yn0;
+			path1 = yn1;
+		}
+
+		// --- odd count: the last section is on path 0
+		if (i < numCoefficients)
+		{
+			double yn0 = (path0 - yState[i])*coefficients[i] + xState[i];
+			xState[i] = path0;
+			yState[i] = yn0;
+			path0 = yn0;
+		}
+	}
+
+	double coefficients[HALFBAND_MAX_COEFFICIENTS] = { 0.0 };	///< allpass coefficients
+	double xState[HALFBAND_MAX_COEFFICIENTS] = { 0.0 };			///< allpass input states
+	double yState[HALFBAND_MAX_COEFFICIENTS] = { 0.0 };			///< allpass output states
+	unsigned int numCoefficients = 0;							///< number of allpass sections
+};
+
+
 /**
 \class PeakLimiter
 \ingroup FX-Objects
@@ -84,6 +84,12 @@ public:
 			customViewIF->pushDataValue(data);
 	}
 
+	virtual void pushDataBlock(const float* data, uint32_t numValues)
+	{
+		if (customViewIF)
+			customViewIF->pushDataBlock(data, numValues);
+	}
+
 	virtual void sendMessage(void* data)
 	{
 		if (customViewIF)
@@ -615,6 +615,8 @@ float CMeterDetector::detect(float input)
             break;
     }
 
+    lastInput = input;
+
     float currEnvelope = 0.0;
     if(input> envelope)
         currEnvelope = attackTime * (envelope - input) + input;
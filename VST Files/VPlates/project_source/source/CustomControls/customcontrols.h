@@ -450,6 +450,9 @@ public:
     void resetPeakHold(){ peakEnvelope = -1.0; }
     void setPeakHold(bool b) { peakHold = b; }
 
+    // --- true when the envelope has reached its input (nothing left to animate); peak hold never moves on its own
+    bool isSettled() { return peakHold || (envelope > lastInput ? envelope - lastInput : lastInput - envelope) < 1.0e-5f; }
+
 protected:
     float attackTime;
     float m_fReleaseTime;
@@ -462,6 +465,7 @@ protected:
     bool  logDetector;
     unsigned int  detectMode;
     bool peakHold;
+    float lastInput = 0.f; ///< last detector input (after squaring for MS/RMS), for isSettled()
 
     void setEnvelope(float value)
     {
@@ -514,6 +518,9 @@ public:
 	void setImageCount(double d){subPixMaps = d;}
 	void setZero_dB_Frame(double d){zero_dB_Frame = d;}
 
+	/** true when the meter has finished its falloff and detector release, so it does not need repainting until its value changes */
+	bool isSettled() { return getOldValue() <= getValue() && detector.isSettled(); }
+
 protected:
 	bool isInverted;
 	bool isAnalogVU;
@@ -34,6 +34,15 @@ PluginCore::PluginCore()
 		addSupportedIOCombination({ kCFMono, kCFMono });
 		addSupportedIOCombination({ kCFMono, kCFStereo });
 		addSupportedIOCombination({ kCFStereo, kCFStereo });
+
+		// --- surround outputs from mono, stereo or the same surround layout (see setPlateChannelLayout( ))
+		const uint32_t surroundFormats[4] = { kCF5p0, kCF5p1, kCF7p1Sony, kCF7p1DTS };
+		for (int i = 0; i < 4; i++)
+		{
+			addSupportedIOCombination({ kCFMono, surroundFormats[i] });
+			addSupportedIOCombination({ kCFStereo, surroundFormats[i] });
+			addSupportedIOCombination({ surroundFormats[i], surroundFormats[i] });
+		}
 	}
 	else // --- synth plugins have no input, only output
 	{
@@ -118,6 +127,20 @@ bool PluginCore::initPluginParameters()
 	piParam->setBoundVariable(&predelay_time, boundVariableType::kDouble);
 	addPluginParameter(piParam);
 
+	// --- discrete control: Engine
+	piParam = new PluginParameter(controlID::engine, "Engine", "Plate,FDN 8,FDN 16,FDN 32,True Stereo", "Plate");
+	piParam->setBoundVariable(&engine, boundVariableType::kInt);
+	piParam->setStateVersion(1);
+	addPluginParameter(piParam);
+
+	// --- continuous control: Cross-Feed
+	piParam = new PluginParameter(controlID::cross_feed, "Cross-Feed", "%", controlVariableType::kDouble, 0.000000, 100.000000, 25.000000, taper::kLinearTaper);
+	piParam->setParameterSmoothing(true);
+	piParam->setSmoothingTimeMsec(100.00);
+	piParam->setBoundVariable(&cross_feed, boundVariableType::kDouble);
+	piParam->setStateVersion(1);
+	addPluginParameter(piParam);
+
 	// --- Aux Attributes
 	AuxParameterAttribute auxAttribute;
 
@@ -157,6 +180,16 @@ bool PluginCore::initPluginParameters()
 	auxAttribute.setUintAttribute(2147483648);
 	setParamAuxAttribute(controlID::predelay_time, auxAttribute);
 
+	// --- controlID::engine
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(268435456);
+	setParamAuxAttribute(controlID::engine, auxAttribute);
+
+	// --- controlID::cross_feed
+	auxAttribute.reset(auxGUIIdentifier::guiControlData);
+	auxAttribute.setUintAttribute(2147483648);
+	setParamAuxAttribute(controlID::cross_feed, auxAttribute);
+
 
 	// **--0xEDA5--**
    
@@ -187,34 +220,89 @@ bool PluginCore::reset(ResetInfo& resetInfo)
     // --- save for audio processing
     audioProcDescriptor.sampleRate = resetInfo.sampleRate;
     audioProcDescriptor.bitDepth = resetInfo.bitDepth;
-	apf1.reset(resetInfo.sampleRate);
-	apf2.reset(resetInfo.sampleRate);
-	apf3.reset(resetInfo.sampleRate);
-	apf4.reset(resetInfo.sampleRate);
-	apf5.reset(resetInfo.sampleRate);
-	apf6.reset(resetInfo.sampleRate);
-	apf1.createDelayBuffer(resetInfo.sampleRate, 211);
-	apf2.createDelayBuffer(resetInfo.sampleRate, 159);
-	apf3.createDelayBuffer(resetInfo.sampleRate, 562);
-	apf4.createDelayBuffer(resetInfo.sampleRate, 411);
-	apf5.createDelayBuffer(resetInfo.sampleRate, 3932);
-	apf6.createDelayBuffer(resetInfo.sampleRate, 2665);
-	DelayAPFParameters apf1p = apf1.getParameters();
-	apf1p.apf_g = 0.75;
-	apf1p.delayTime_mSec = 210/44.1;
-	apf1.setParameters(apf1p);
-	DelayAPFParameters apf2p = apf2.getParameters();
-	apf2p.apf_g = 0.75;
-	apf2p.delayTime_mSec = 158/44.1;
-	apf2.setParameters(apf2p);
-	DelayAPFParameters apf3p = apf3.getParameters();
-	apf3p.apf_g = 0.625;
-	apf3p.delayTime_mSec = 561/44.1;
-	apf3.setParameters(apf3p);
-	DelayAPFParameters apf4p = apf4.getParameters();
-	apf4p.apf_g = 0.625;
-	apf4p.delayTime_mSec = 410/44.1;
-	apf4.setParameters(apf4p);
+	audioProcDescriptor.processMode = resetInfo.processMode;
+
+	// --- offline renders (bounces) get the high quality engine: oversampled tank and
+	//     4-point Lagrange reads in the modulated APFs; real-time playback keeps the lean engine
+	//     at high host rates real-time playback runs the tank at a reduced rate instead, when its passband
+	//     holds every Damping/Low Pass setting; the rate only changes here, so no control move can cut the tail
+	bool highQuality = resetInfo.processMode == kOfflineProcessMode;
+	oversamplingRatio = highQuality ? kOfflineOversamplingRatio : 1;
+	decimationRatio = highQuality ? 1 : chooseTankDecimationRatio(resetInfo.sampleRate);
+	prepareTank(resetInfo.sampleRate);
+
+	// --- re-uses the memory reserved in initialize( ), no allocation
+	for (uint32_t i = 0; i < kMaxPlateChannels; i++)
+		dryDelay[i].createDelayBuffer(resetInfo.sampleRate, kMaxTankLag_mSec);
+
+	// --- silence detection: a quiet stretch must outlast the longest path through the network
+	double maxPreDelay_mSec = getPluginParameterByControlID(controlID::predelay_time)->getMaxValue();
+	samplesToSleep = (uint32_t)(resetInfo.sampleRate*(maxPreDelay_mSec + getDiffuserTime_mSec() + getTankLoopTime_mSec()) / 1000.0);
+	quietSampleCount = 0;
+	tankAsleep = false;
+	flushIndex = 0;
+
+	// --- the delay lines were just cleared, so a pending engine switch can finish now
+	tankFadeLength = (uint32_t)fmax(1.0, resetInfo.sampleRate*kTankSwitchFade_mSec / 1000.0);
+	tankFlushed = true;
+	completeTankSwitch();
+
+	// --- report tail to host
+	pluginDescriptor.tailTimeInMSec = calculateTailTime_mSec();
+
+    // --- other reset inits
+    return PluginBase::reset(resetInfo);
+}
+
+/**
+\brief set up every tank object for engineSampleRate = sampleRate*oversamplingRatio/decimationRatio; called from reset( )
+
+NOTES:
+- re-uses the delay memory reserved in initialize( ), so this does not allocate; it does clear every line
+- the DSP objects get their fixed settings here; UpdateParameters( ) applies the control values on top
+- AudioFilter::reset( ) keeps the old coefficients and setParameters( ) skips unchanged settings, so the filters
+  also get setSampleRate( ); otherwise a new tank rate would run them with the coefficients of the old one
+- the reduced rate tank lags the host rate tank by tankLag_mSec, see initResamplingFilters( )
+
+\param sampleRate the host sample rate
+*/
+void PluginCore::prepareTank(double sampleRate)
+{
+	bool highQuality = oversamplingRatio > 1;
+	engineSampleRate = sampleRate*oversamplingRatio / decimationRatio;
+	initResamplingFilters(sampleRate);
+
+	inputDiffuser.reset(engineSampleRate);
+	apf5.reset(engineSampleRate);
+	apf6.reset(engineSampleRate);
+
+	// --- true stereo engine
+	rightInputDiffuser.reset(engineSampleRate);
+	for (int i = 0; i < 2; i++)
+	{
+		stereoModAPF[i].reset(engineSampleRate);
+		stereoAPF[i].reset(engineSampleRate);
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		stereoLPF[i].reset(engineSampleRate);
+		stereoLPF[i].setSampleRate(engineSampleRate);
+	}
+	stereoX3[0] = stereoX3[1] = 0.0;
+
+	// --- re-uses the memory reserved in initialize( ), no allocation
+	createDelayBuffers(engineSampleRate);
+
+	InputDiffuserParameters diffuserp = inputDiffuser.getParameters();
+	diffuserp.apf_g[0] = 0.75;
+	diffuserp.delayTime_mSec[0] = 210/44.1;
+	diffuserp.apf_g[1] = 0.75;
+	diffuserp.delayTime_mSec[1] = 158/44.1;
+	diffuserp.apf_g[2] = 0.625;
+	diffuserp.delayTime_mSec[2] = 561/44.1;
+	diffuserp.apf_g[3] = 0.625;
+	diffuserp.delayTime_mSec[3] = 410/44.1;
+	inputDiffuser.setParameters(diffuserp);
 	DelayAPFParameters apf5p = apf5.getParameters();
 	apf5p.apf_g = 0.5;
 	apf5p.delayTime_mSec = 3931/44.1;
@@ -224,21 +312,14 @@ bool PluginCore::reset(ResetInfo& resetInfo)
 	apf5p.delayTime_mSec = 2664/44.1;
 	apf6.setParameters(apf6p);
 
-	delay1.reset(resetInfo.sampleRate);
-	delay2.reset(resetInfo.sampleRate);
-	delay3.reset(resetInfo.sampleRate);
-	delay4.reset(resetInfo.sampleRate);
-	delay1.createDelayBuffer(resetInfo.sampleRate, 6241);
-	delay2.createDelayBuffer(resetInfo.sampleRate, 6590);
-	delay3.createDelayBuffer(resetInfo.sampleRate, 4641);
-	delay4.createDelayBuffer(resetInfo.sampleRate, 5505);
-	preDelay.reset(resetInfo.sampleRate);
-	preDelay.createDelayBuffer(resetInfo.sampleRate, 1024);
-
-	modAPF1.reset(resetInfo.sampleRate);
-	modAPF2.reset(resetInfo.sampleRate);
-	modAPF1.createDelayBuffer(resetInfo.sampleRate, 1363);
-	modAPF2.createDelayBuffer(resetInfo.sampleRate, 1105);
+	delay1.reset(engineSampleRate);
+	delay2.reset(engineSampleRate);
+	delay3.reset(engineSampleRate);
+	delay4.reset(engineSampleRate);
+	preDelay.reset(engineSampleRate);
+
+	modAPF1.reset(engineSampleRate);
+	modAPF2.reset(engineSampleRate);
 	DelayAPFParameters mod1p = modAPF1.getParameters();
 	mod1p.lfoMaxModulation_mSec = 100;
 	mod1p.enableLFO = true;
@@ -246,6 +327,8 @@ bool PluginCore::reset(ResetInfo& resetInfo)
 	mod1p.lfoRate_Hz = 0.1;
 	mod1p.lfoDepth = 0.1;
 	mod1p.delayTime_mSec = 1343/44.1;
+	mod1p.interpolate = highQuality;
+	mod1p.interpolationType = interpolation::kLagrange4;
 	modAPF1.setParameters(mod1p);
 	DelayAPFParameters mod2p = modAPF2.getParameters();
 	mod2p.lfoMaxModulation_mSec = 100;
@@ -254,17 +337,204 @@ bool PluginCore::reset(ResetInfo& resetInfo)
 	mod2p.lfoRate_Hz = 0.1;
 	mod2p.lfoDepth = 0.1;
 	mod2p.delayTime_mSec = 995/44.1;
+	mod2p.interpolate = highQuality;
+	mod2p.interpolationType = interpolation::kLagrange4;
 	modAPF2.setParameters(mod2p);
 	for (int i = 0; i < 3; i++) {
-		LPF[i].reset(resetInfo.sampleRate);
+		LPF[i].reset(engineSampleRate);
 		AudioFilterParameters LPFparams = LPF[i].getParameters();
 		LPFparams.algorithm = filterAlgorithm::kLPF1;
 		LPFparams.fc = 10000;
 		LPF[i].setParameters(LPFparams);
+		LPF[i].setSampleRate(engineSampleRate);
 	}
-	
-    // --- other reset inits
-    return PluginBase::reset(resetInfo);
+
+	fdn.reset(engineSampleRate);
+	updateFDNParameters();
+	updateTrueStereoParameters();
+}
+
+/**
+\brief size the delay lines of every tank object for a sample rate
+
+Operation:
+- lengths are the longest delay or output tap of each object, in samples at 44.1kHz (the Dattorro plate tuning),
+  converted to mSec so they scale with the sample rate
+- called once from initialize( ) at kMaxPreparedSampleRate with oversampling, which allocates; every later call
+  (from reset( )) fits into that memory and only rescales the wrap masks and flushes
+
+\param sampleRate the tank (engine) sample rate
+*/
+void PluginCore::createDelayBuffers(double sampleRate)
+{
+	const double diffuserLength_mSec[INPUT_DIFFUSER_STAGES] = { 211/44.1, 159/44.1, 562/44.1, 411/44.1 };
+	inputDiffuser.createDelayBuffers(sampleRate, diffuserLength_mSec);
+	apf5.createDelayBuffer(sampleRate, kTankLineLength[1]/44.1);
+	apf6.createDelayBuffer(sampleRate, kTankLineLength[4]/44.1);
+	delay1.createDelayBuffer(sampleRate, kTankLineLength[0]/44.1);
+	delay2.createDelayBuffer(sampleRate, kTankLineLength[2]/44.1);
+	delay3.createDelayBuffer(sampleRate, kTankLineLength[3]/44.1);
+	delay4.createDelayBuffer(sampleRate, kTankLineLength[5]/44.1);
+	modAPF1.createDelayBuffer(sampleRate, 1363/44.1);
+	modAPF2.createDelayBuffer(sampleRate, 1105/44.1);
+
+	double maxPreDelay_mSec = getPluginParameterByControlID(controlID::predelay_time)->getMaxValue();
+	preDelay.createDelayBuffer(sampleRate, maxPreDelay_mSec);
+
+	fdn.createDelayBuffers(sampleRate, kFDNMaxDelay_mSec);
+
+	// --- true stereo engine: the same lines, two lanes each
+	rightInputDiffuser.createDelayBuffers(sampleRate, diffuserLength_mSec);
+	stereoAPF[0].createDelayBuffer(sampleRate, kTankLineLength[1]/44.1);
+	stereoAPF[1].createDelayBuffer(sampleRate, kTankLineLength[4]/44.1);
+	stereoDelay[0].createDelayBuffer(sampleRate, kTankLineLength[0]/44.1);
+	stereoDelay[1].createDelayBuffer(sampleRate, kTankLineLength[2]/44.1);
+	stereoDelay[2].createDelayBuffer(sampleRate, kTankLineLength[3]/44.1);
+	stereoDelay[3].createDelayBuffer(sampleRate, kTankLineLength[5]/44.1);
+	stereoModAPF[0].createDelayBuffer(sampleRate, 1363/44.1);
+	stereoModAPF[1].createDelayBuffer(sampleRate, 1105/44.1);
+	stereoPreDelay.createDelayBuffer(sampleRate, maxPreDelay_mSec);
+}
+
+/**
+\brief setup the anti-imaging and anti-aliasing filters around the oversampled tank
+
+\param sampleRate the host sample rate
+*/
+void PluginCore::initResamplingFilters(double sampleRate)
+{
+	// --- reduced rate tank
+	for (int i = 0; i < 2; i++)
+	{
+		tankDecimator[i][0].initialize(kHalfBandCoefficients, kHalfBandTransition);
+		tankDecimator[i][1].initialize(kHalfBandOuterCoefficients, kHalfBandOuterTransition);
+	}
+	for (uint32_t i = 0; i < kMaxTankOutputs; i++)
+	{
+		tankInterpolator[i][0].initialize(kHalfBandCoefficients, kHalfBandTransition);
+		tankInterpolator[i][1].initialize(kHalfBandOuterCoefficients, kHalfBandOuterTransition);
+	}
+	memset(decimatorInput, 0, sizeof(decimatorInput));
+	memset(interpolatedOutput, 0, sizeof(interpolatedOutput));
+	decimationPhase = 0;
+
+	// --- wet path lag: the DC group delay of each half-band stage on the way in and out, plus the host sample a
+	//     tank output waits for its decimationPhase slot (see processPlate( )); the inner stage runs at half rate for 4x
+	double lag_Samples = 0.0;
+	if (decimationRatio > 1)
+	{
+		lag_Samples = 1.0 + 2.0*tankDecimator[0][0].getGroupDelay()*(decimationRatio / 2);
+		if (decimationRatio == 4)
+			lag_Samples += 2.0*tankDecimator[0][1].getGroupDelay();
+	}
+	tankLag_mSec = lag_Samples*1000.0 / sampleRate;
+
+	// --- oversampled tank
+
+	AudioFilter* filters[2 + kMaxTankOutputs] = { &upsampleLPF[0][0], &upsampleLPF[1][0] };
+	for (uint32_t i = 0; i < kMaxTankOutputs; i++)
+		filters[2 + i] = &downsampleLPF[i][0];
+	for (uint32_t i = 0; i < 2 + kMaxTankOutputs; i++)
+	{
+		for (uint32_t j = 0; j < kNumResamplingFilterStages; j++)
+		{
+			filters[i][j].reset(engineSampleRate);
+			AudioFilterParameters params = filters[i][j].getParameters();
+			params.algorithm = filterAlgorithm::kButterLPF2;
+			params.fc = kResamplingFilter_fc*sampleRate;
+			filters[i][j].setParameters(params);
+
+			// --- recalculate even if fc did not change: the same host rate gives a different engineSampleRate
+			//     offline; with a reduced rate tank fc is above its Nyquist frequency (the filters are not run then)
+			filters[i][j].setSampleRate(engineSampleRate);
+		}
+	}
+}
+
+/**
+\brief pick the lowest tank rate that keeps the audible band
+
+Operation:
+- halve the rate (up to kMaxTankDecimationRatio) while the new rate stays at or above kMinReducedTankSampleRate and
+  its half-band passband still covers the top of the Low Pass and Damping ranges (capped at kMaxTankBandwidth)
+- the ranges rather than the settings: the rate then holds for any control move and only reset( ) picks it
+- 96k and 192k sessions get 48k tanks, 176.4k gets an 88.2k tank; 88.2k runs at the host rate (a 44.1k tank's
+  passband stops short of 20kHz)
+
+\param sampleRate the host sample rate
+
+\return decimation ratio 1, 2 or 4
+*/
+uint32_t PluginCore::chooseTankDecimationRatio(double sampleRate)
+{
+	if (!enableReducedRateTank)
+		return 1;
+
+	double lowpass_fc = getPluginParameterByControlID(controlID::lowpass_freq)->getMaxValue();
+	double damping_fc = getPluginParameterByControlID(controlID::damping)->getMaxValue();
+	double bandwidth = fmin(fmax(lowpass_fc, damping_fc), kMaxTankBandwidth);
+
+	uint32_t ratio = 1;
+	while (ratio < kMaxTankDecimationRatio)
+	{
+		double reducedRate = sampleRate / (ratio * 2);
+		if (reducedRate < kMinReducedTankSampleRate || bandwidth > kHalfBandPassband*reducedRate)
+			break;
+		ratio *= 2;
+	}
+	return ratio;
+}
+
+/**
+\brief sum of the input diffuser delays
+
+\return diffuser delay time in mSec
+*/
+double PluginCore::getDiffuserTime_mSec()
+{
+	return inputDiffuser.getTotalDelay_mSec();
+}
+
+/**
+\brief time for one trip around the figure-8 tank (both halves)
+
+\return tank loop time in mSec
+*/
+double PluginCore::getTankLoopTime_mSec()
+{
+	return modAPF1.getParameters().delayTime_mSec + delay1.getParameters().delayTime_mSec +
+		   apf5.getParameters().delayTime_mSec + delay2.getParameters().delayTime_mSec +
+		   modAPF2.getParameters().delayTime_mSec + delay3.getParameters().delayTime_mSec +
+		   apf6.getParameters().delayTime_mSec + delay4.getParameters().delayTime_mSec;
+}
+
+/**
+\brief calculate the time for an impulse to decay by kTankSilenceThreshold_dB
+
+Operation:
+- maximum pre-delay + diffuser ringing + the number of tank loops needed at loop gain G^2, plus one extra loop for the output taps
+- each diffuser APF rings down by apf_g per trip around its own delay
+
+\return tail time in mSec
+*/
+double PluginCore::calculateTailTime_mSec()
+{
+	double diffuser_mSec = 0.0;
+	InputDiffuserParameters diffuserParams = inputDiffuser.getParameters();
+	for (unsigned int i = 0; i < INPUT_DIFFUSER_STAGES; i++)
+	{
+		double trips = kTankSilenceThreshold_dB / (20.0*log10(fmax(fabs(diffuserParams.apf_g[i]), 1.0e-6)));
+		diffuser_mSec += diffuserParams.delayTime_mSec[i]*fmax(trips, 1.0);
+	}
+
+	// --- use the parameters rather than the bound variables, which may not be synced yet
+	double g = getPluginParameterByControlID(controlID::decay)->getControlValue();
+	double maxPreDelay_mSec = getPluginParameterByControlID(controlID::predelay_time)->getMaxValue();
+
+	double loopGain_dB = 20.0*log10(fmax(g*g, 1.0e-12));
+	double loops = kTankSilenceThreshold_dB / loopGain_dB;
+
+	return maxPreDelay_mSec + diffuser_mSec + getTankLoopTime_mSec()*(fmax(loops, 0.0) + 1.0);
 }
 
 void PluginCore::UpdateParameters() {
@@ -288,9 +558,73 @@ void PluginCore::UpdateParameters() {
 	mod1Params.lfoRate_Hz = mod_rate;
 	modAPF2.setParameters(mod2Params);
 
+	// --- the reduced rate tank's lag comes out of the pre-delay; the dry path waits for whatever is left
 	SimpleDelayParameters preDelayParams = preDelay.getParameters();
-	preDelayParams.delayTime_mSec = predelay_time;
+	preDelayParams.delayTime_mSec = fmax(0.0, predelay_time - tankLag_mSec);
 	preDelay.setParameters(preDelayParams);
+	dryDelay_mSec = fmax(0.0, tankLag_mSec - predelay_time);
+
+	// --- engine switch: start the new engine from silence rather than from the tail it held when it was last used
+	bool useTrueStereo = compareEnumToInt(engineEnum::True_Stereo, engine);
+	bool useFDN = !useTrueStereo && !compareEnumToInt(engineEnum::Plate, engine);
+	requestTankSwitch(useFDN, useTrueStereo);
+	if (useFDN)
+		updateFDNParameters();
+	if (useTrueStereo)
+		updateTrueStereoParameters();
+}
+
+/**
+\brief map the plate controls onto the FDN
+
+Operation:
+- RT60 is the time the plate takes to decay by 60dB: its loop gain is G^2 per trip around the tank
+- damping sets the fc of the per-line damping filters
+- the line count comes from the Engine setting; offline renders (high quality engine) always use FDN_MAX_LINES
+*/
+void PluginCore::updateFDNParameters()
+{
+	FDNReverbParameters params = fdn.getParameters();
+
+	uint32_t engineIndex = (uint32_t)engine < 4 ? (uint32_t)engine : 0;
+	params.numLines = oversamplingRatio > 1 ? FDN_MAX_LINES : kFDNLinesPerEngine[engineIndex];
+	if (params.numLines == 0)
+		params.numLines = kFDNLinesPerEngine[1];
+
+	double loopGain_dB = 20.0*log10(fmax(G*G, 1.0e-12));
+	params.RT60Time_mSec = getTankLoopTime_mSec()*(-60.0 / loopGain_dB);
+	params.damping_fc = damping;
+	params.minDelay_mSec = kFDNMinDelay_mSec;
+	params.maxDelay_mSec = kFDNMaxDelay_mSec;
+	fdn.setParameters(params);
+}
+
+/**
+\brief copy the plate settings to the true stereo engine
+
+Operation:
+- every lane object takes the parameters of the plate object it stands in for, so each lane is the plate
+- Cross-Feed rotates the two lanes' tank feedback by 0 (independent tanks) to 45 degrees (equal parts of each);
+  a rotation keeps the loop energy, so the decay time does not change with it
+*/
+void PluginCore::updateTrueStereoParameters()
+{
+	stereoPreDelay.setParameters(preDelay.getParameters());
+	for (int i = 0; i < 3; i++)
+		stereoLPF[i].setParameters(LPF[i].getParameters());
+	rightInputDiffuser.setParameters(inputDiffuser.getParameters());
+	stereoModAPF[0].setParameters(modAPF1.getParameters());
+	stereoModAPF[1].setParameters(modAPF2.getParameters());
+	stereoAPF[0].setParameters(apf5.getParameters());
+	stereoAPF[1].setParameters(apf6.getParameters());
+	stereoDelay[0].setParameters(delay1.getParameters());
+	stereoDelay[1].setParameters(delay2.getParameters());
+	stereoDelay[2].setParameters(delay3.getParameters());
+	stereoDelay[3].setParameters(delay4.getParameters());
+
+	double crossFeedAngle = cross_feed < kMinCrossFeed_Percent ? 0.0 : (cross_feed / 100.0)*(kPi / 4.0);
+	crossFeedCos = cos(crossFeedAngle);
+	crossFeedSin = sin(crossFeedAngle);
 }
 
 /**
@@ -298,11 +632,32 @@ void PluginCore::UpdateParameters() {
 
 Operation:
 - saves structure for the plugin to use; you can also load WAV files or state information here
+- preallocates the DSP memory, see createDelayBuffers( )
 */
 bool PluginCore::initialize(PluginInfo& pluginInfo)
 {
 	// --- add one-time init stuff here
 
+	// --- compact storage for the long tank lines; must be chosen before the buffers are created
+	delay1.setStorageType(kTankLineStorage);
+	delay2.setStorageType(kTankLineStorage);
+	delay3.setStorageType(kTankLineStorage);
+	delay4.setStorageType(kTankLineStorage);
+	fdn.setStorageType(kTankLineStorage);
+
+	// --- dry path delay for the reduced rate tank: fractional, it follows the pre-delay smoothly
+	for (uint32_t i = 0; i < kMaxPlateChannels; i++)
+	{
+		dryDelay[i].createDelayBuffer(kMaxPreparedSampleRate, kMaxTankLag_mSec);
+		SimpleDelayParameters dryParams = dryDelay[i].getParameters();
+		dryParams.interpolate = true;
+		dryDelay[i].setParameters(dryParams);
+	}
+
+	// --- reserve all delay memory for the highest rate we support (offline engine included),
+	//     so reset( ) never allocates; rates above kMaxPreparedSampleRate still work, but allocate in reset( )
+	createDelayBuffers(kMaxPreparedSampleRate*kOfflineOversamplingRatio);
+
 	return true;
 }
 
@@ -334,8 +689,9 @@ bool PluginCore::preProcessAudioBuffers(ProcessBufferInfo& processInfo)
 
 Operation:
 - decode the plugin type - for synth plugins, fill in the rendering code; for FX plugins, delete the if(synth) portion and add your processing code
-- note that MIDI events are fired for each sample interval so that MIDI is tightly sunk with audio
-- doSampleAccurateParameterUpdates will perform per-sample interval smoothing
+- MIDI events and VST3 sample accurate automation are applied by the sub-block scheduler in PluginBase::processAudioBuffers( )
+  before the frames they land on, so they are not polled here
+- doSampleAccurateParameterUpdates will perform per-sample interval smoothing; the DSP objects are only updated when it reports a change
 
 \param processFrameInfo structure of information about *frame* processing
 
@@ -343,12 +699,10 @@ Operation:
 */
 bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 {
-    // --- fire any MIDI events for this sample interval
-    processFrameInfo.midiEventQueue->fireMidiEvents(processFrameInfo.currentFrame);
+	// --- do per-frame updates; parameter smoothing (and anything the scheduler or snapshot changed)
+	if (doSampleAccurateParameterUpdates())
+		UpdateParameters();
 
-	// --- do per-frame updates; VST automation and parameter smoothing
-	doSampleAccurateParameterUpdates();
-	UpdateParameters();
     // --- decode the channelIOConfiguration and process accordingly
     //
 	// --- Synth Plugin:
@@ -381,51 +735,12 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 		double L = processFrameInfo.audioInputFrame[0];
 		//double R = processFrameInfo.audioInputFrame[1];
 		//double inputSum = (L + R) * 0.5;
-		double pre = preDelay.processAudioSample(L);
-		double lp1 = LPF[0].processAudioSample(pre);
-		double AP1 = apf1.processAudioSample(lp1);
-		double AP2 = apf2.processAudioSample(AP1);
-		double AP3 = apf3.processAudioSample(AP2);
-		double AP4 = apf4.processAudioSample(AP3);
-		x1 = AP4;
-		double sumX1X2 = x1 + x3;
-		double mod1 = modAPF1.processAudioSample(sumX1X2);
-		double del1 = delay1.processAudioSample(mod1);
-		double LP2 = LPF[1].processAudioSample(del1);
-		double AP5 = apf5.processAudioSample(LP2);
-		double del2 = delay2.processAudioSample(AP5);
-		x2 = del2;
-		x2 *= G;
-		double mod2 = modAPF2.processAudioSample(x2);
-		double del3 = delay3.processAudioSample(mod2);
-		double LP3 = LPF[2].processAudioSample(del3);
-		double AP6 = apf6.processAudioSample(LP3);
-		double del4 = delay4.processAudioSample(AP6);
-		x3 = del4;
-		x3 *= G;
-		double a1 = delay1.readDelayAtTime_mSec(394/44.1);
-		double a2 = delay1.readDelayAtTime_mSec(4401/44.1);
-		double a3 = delay1.readDelayAtTime_mSec(3124/44.1);
-		double b1 = apf5.readDelay(2831/44.1);
-		double b2 = apf5.readDelay(496/44.1);
-		double c1 = delay2.readDelayAtTime_mSec(2954/44.1);
-		double c2 = delay2.readDelayAtTime_mSec(179/44.1);
-		double d1 = delay3.readDelayAtTime_mSec(2945/44.1);
-		double d2 = delay3.readDelayAtTime_mSec(522/44.1);
-		double d3 = delay3.readDelayAtTime_mSec(5368/44.1);
-		double e1 = apf6.readDelay(277/44.1);
-		double e2 = apf6.readDelay(1817/44.1);
-		double f1 = delay4.readDelayAtTime_mSec(1578/44.1);
-		double f2 = delay4.readDelayAtTime_mSec(3956/44.1);
-
-		double yL = 0;
-		double yR = 0;
-		yL = a1 + a2 - b1 + c1 - d1 - e1 - f1;
-		yR = d2 + d3 - e2 + f2 - a3 - b2 - c2;
+		double yn[kMaxTankOutputs];
+		processPlate(L, L, yn);
 		double wet = (wet_mix / 100);
 		double dry = (1 - wet_mix / 100);
-        processFrameInfo.audioOutputFrame[0] = yL * wet + L * dry;//processFrameInfo.audioInputFrame[0];
-        processFrameInfo.audioOutputFrame[1] = yR * wet + L * dry;//processFrameInfo.audioInputFrame[0];
+        processFrameInfo.audioOutputFrame[0] = yn[0] * wet + processDryDelay(0, L) * dry;//processFrameInfo.audioInputFrame[0];
+        processFrameInfo.audioOutputFrame[1] = yn[1] * wet + processDryDelay(1, L) * dry;//processFrameInfo.audioInputFrame[0];
 
         return true; /// processed
     }
@@ -438,52 +753,28 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
 		// --- pass through code: change this with your signal processing
 		double L = processFrameInfo.audioInputFrame[0];
 		double R = processFrameInfo.audioInputFrame[1];
-		double inputSum = (L + R) * 0.5;
-		double pre = preDelay.processAudioSample(inputSum);
-		double lp1 = LPF[0].processAudioSample(pre);
-		double AP1 = apf1.processAudioSample(lp1);
-		double AP2 = apf2.processAudioSample(AP1);
-		double AP3 = apf3.processAudioSample(AP2);
-		double AP4 = apf4.processAudioSample(AP3);
-		x1 = AP4;
-		double sumX1X2 = x1 + x3;
-		double mod1 = modAPF1.processAudioSample(sumX1X2);
-		double del1 = delay1.processAudioSample(mod1);
-		double LP2 = LPF[1].processAudioSample(del1);
-		double AP5 = apf5.processAudioSample(LP2);
-		double del2 = delay2.processAudioSample(AP5);
-		x2 = del2;
-		x2 *= G;
-		double mod2 = modAPF2.processAudioSample(x2);
-		double del3 = delay3.processAudioSample(mod2);
-		double LP3 = LPF[2].processAudioSample(del3);
-		double AP6 = apf6.processAudioSample(LP3);
-		double del4 = delay4.processAudioSample(AP6);
-		x3 = del4;
-		x3 *= G;
-		double a1 = delay1.readDelayAtTime_mSec(394/44.1);
-		double a2 = delay1.readDelayAtTime_mSec(4401/44.1);
-		double a3 = delay1.readDelayAtTime_mSec(3124/44.1);
-		double b1 = apf5.readDelay(2831/44.1);
-		double b2 = apf5.readDelay(496/44.1);
-		double c1 = delay2.readDelayAtTime_mSec(2954/44.1);
-		double c2 = delay2.readDelayAtTime_mSec(179/44.1);
-		double d1 = delay3.readDelayAtTime_mSec(2945/44.1);
-		double d2 = delay3.readDelayAtTime_mSec(522/44.1);
-		double d3 = delay3.readDelayAtTime_mSec(5368/44.1);
-		double e1 = apf6.readDelay(277/44.1);
-		double e2 = apf6.readDelay(1817/44.1);
-		double f1 = delay4.readDelayAtTime_mSec(1578/44.1);
-		double f2 = delay4.readDelayAtTime_mSec(3956/44.1);
-
-		double yL = 0;
-		double yR = 0;
-		yL = a1 + a2 - b1 + c1 - d1 - e1 - f1;
-		yR = d2 + d3 - e2 + f2 - a3 - b2 - c2;
+		double yn[kMaxTankOutputs];
+		processPlate(L, R, yn);
 		double wet = (wet_mix / 100);
 		double dry = (1 - wet_mix / 100);
-		processFrameInfo.audioOutputFrame[0] = yL *wet + L *dry;//processFrameInfo.audioInputFrame[0];
-		processFrameInfo.audioOutputFrame[1] = yR *wet + R *dry;//processFrameInfo.audioInputFrame[1];
+		processFrameInfo.audioOutputFrame[0] = yn[0] *wet + processDryDelay(0, L) *dry;//processFrameInfo.audioInputFrame[0];
+		processFrameInfo.audioOutputFrame[1] = yn[1] *wet + processDryDelay(1, R) *dry;//processFrameInfo.audioInputFrame[1];
+
+        return true; /// processed
+    }
+
+    // --- Mono/Stereo/Surround-In/Surround-Out
+    else if (setPlateChannelLayout(processFrameInfo.channelIOConfig.inputChannelFormat, processFrameInfo.channelIOConfig.outputChannelFormat))
+    {
+		double input[kMaxPlateChannels];
+		double output[kMaxPlateChannels];
+		for (uint32_t i = 0; i < numPlateInputChannels; i++)
+			input[i] = processFrameInfo.audioInputFrame[i];
+
+		processSurroundFrame(input, output);
+
+		for (uint32_t i = 0; i < numPlateOutputChannels; i++)
+			processFrameInfo.audioOutputFrame[i] = output[i];
 
         return true; /// processed
     }
@@ -491,6 +782,785 @@ bool PluginCore::processAudioFrame(ProcessFrameInfo& processFrameInfo)
     return false; /// NOT processed
 }
 
+/**
+\brief one host sample through the plate; runs the tank oversamplingRatio times for the high quality engine,
+or once every decimationRatio samples for the reduced rate tank
+
+Operation:
+- oversampling: zero-stuffed input through the anti-imaging LPF, tank outputs through the anti-aliasing LPFs,
+  keep the last of every oversamplingRatio outputs
+- reduced rate: collect decimationRatio inputs, then run the tank once (see processReducedRateTank( )); the wet
+  output lags by tankLag_mSec, which UpdateParameters( ) takes out of the pre-delay (or adds to the dry path)
+- the true stereo engine resamples both inputs; the others take the mono sum, which is exact for mono-in (xnL == xnR)
+
+\param xnL left input
+\param xnR right input (the left input again for mono-in)
+\param yn the numTankOutputs tank outputs (wet only): L, R, then the surround outputs
+*/
+void PluginCore::processPlate(double xnL, double xnR, double* yn)
+{
+	// --- engine switch: the tank is muted while it is flushed
+	if (tankSwitchPending && tankFadeSamples == 0)
+	{
+		for (uint32_t i = 0; i < numTankOutputs; i++)
+			yn[i] = 0.0;
+		return;
+	}
+	tankFlushed = false;
+
+	uint32_t numInputs = trueStereoEngineActive ? 2 : 1;
+	double xn[2] = { xnL, xnR };
+	if (!trueStereoEngineActive)
+		xn[0] = xn[1] = (xnL + xnR) * 0.5;
+
+	if (decimationRatio > 1)
+	{
+		decimatorInput[0][decimationPhase] = xn[0];
+		decimatorInput[1][decimationPhase] = xn[1];
+		for (uint32_t i = 0; i < numTankOutputs; i++)
+			yn[i] = interpolatedOutput[i][decimationPhase];
+
+		if (++decimationPhase == decimationRatio)
+		{
+			decimationPhase = 0;
+			processReducedRateTank();
+		}
+	}
+	else if (oversamplingRatio == 1)
+		processTankEngine(xn[0], xn[1], yn);
+	else
+	{
+		for (uint32_t i = 0; i < oversamplingRatio; i++)
+		{
+			double up[2] = { 0.0, 0.0 };
+			for (uint32_t c = 0; c < numInputs; c++)
+			{
+				up[c] = i == 0 ? xn[c]*oversamplingRatio : 0.0;
+				for (uint32_t j = 0; j < kNumResamplingFilterStages; j++)
+					up[c] = upsampleLPF[c][j].processAudioSample(up[c]);
+			}
+			if (numInputs == 1)
+				up[1] = up[0];
+
+			processTankEngine(up[0], up[1], yn);
+
+			for (uint32_t k = 0; k < numTankOutputs; k++)
+			{
+				for (uint32_t j = 0; j < kNumResamplingFilterStages; j++)
+					yn[k] = downsampleLPF[k][j].processAudioSample(yn[k]);
+			}
+		}
+	}
+	trackTankSilence(fmax(fabs(xn[0]), fabs(xn[1])), yn[0], yn[1]);
+
+	// --- engine switch: fade the old engine out, then start the flush
+	if (tankSwitchPending)
+	{
+		double gain = (double)(--tankFadeSamples) / (double)tankFadeLength;
+		for (uint32_t i = 0; i < numTankOutputs; i++)
+			yn[i] *= gain;
+		if (tankFadeSamples == 0)
+			flushIndex = 0;
+	}
+}
+
+/**
+\brief ask for a different engine
+
+Operation:
+- nothing to do if that is what runs now (or what a pending switch will start)
+- an empty tank switches at once; otherwise the old tank fades out over kTankSwitchFade_mSec, then the muted tank
+  is flushed one object per buffer (see processAudioBuffers( )) and completeTankSwitch( ) starts the new one
+
+\param useFDN run the FDN engine
+\param useTrueStereo run the true stereo engine
+*/
+void PluginCore::requestTankSwitch(bool useFDN, bool useTrueStereo)
+{
+	bool nextFDN = tankSwitchPending ? pendingFDNEngine : fdnEngineActive;
+	bool nextTrueStereo = tankSwitchPending ? pendingTrueStereoEngine : trueStereoEngineActive;
+	if (useFDN == nextFDN && useTrueStereo == nextTrueStereo)
+		return;
+
+	pendingFDNEngine = useFDN;
+	pendingTrueStereoEngine = useTrueStereo;
+	if (!tankSwitchPending)
+	{
+		tankSwitchPending = true;
+		tankFadeSamples = tankFadeLength;
+	}
+
+	// --- nothing to fade or flush
+	if (tankFlushed)
+		completeTankSwitch();
+}
+
+/**
+\brief start the engine requested with requestTankSwitch( ); called once the tank has been flushed (or had nothing in it)
+*/
+void PluginCore::completeTankSwitch()
+{
+	if (!tankSwitchPending)
+		return;
+
+	fdnEngineActive = pendingFDNEngine;
+	trueStereoEngineActive = pendingTrueStereoEngine;
+	tankSwitchPending = false;
+	tankFadeSamples = 0;
+}
+
+/**
+\brief one tank sample through the reduced rate tank: half-band decimate the collected host samples,
+run the tank, half-band interpolate its outputs back to the host rate
+*/
+void PluginCore::processReducedRateTank()
+{
+	uint32_t numInputs = trueStereoEngineActive ? 2 : 1;
+	double xn[2] = { 0.0, 0.0 };
+	for (uint32_t c = 0; c < numInputs; c++)
+	{
+		if (decimationRatio == 4)
+		{
+			double half0 = tankDecimator[c][1].decimateAudio(decimatorInput[c][0], decimatorInput[c][1]);
+			double half1 = tankDecimator[c][1].decimateAudio(decimatorInput[c][2], decimatorInput[c][3]);
+			xn[c] = tankDecimator[c][0].decimateAudio(half0, half1);
+		}
+		else
+			xn[c] = tankDecimator[c][0].decimateAudio(decimatorInput[c][0], decimatorInput[c][1]);
+	}
+	if (numInputs == 1)
+		xn[1] = xn[0];
+
+	double tankOut[kMaxTankOutputs];
+	processTankEngine(xn[0], xn[1], tankOut);
+
+	for (uint32_t i = 0; i < numTankOutputs; i++)
+	{
+		double y0 = 0.0;
+		double y1 = 0.0;
+		tankInterpolator[i][0].interpolateAudio(tankOut[i], y0, y1);
+		if (decimationRatio == 4)
+		{
+			tankInterpolator[i][1].interpolateAudio(y0, interpolatedOutput[i][0], interpolatedOutput[i][1]);
+			tankInterpolator[i][1].interpolateAudio(y1, interpolatedOutput[i][2], interpolatedOutput[i][3]);
+		}
+		else
+		{
+			interpolatedOutput[i][0] = y0;
+			interpolatedOutput[i][1] = y1;
+		}
+	}
+}
+
+/**
+\brief one sample (at engineSampleRate) through whichever engine is selected
+
+\param xnL left tank input
+\param xnR right tank input; the mono engines only use xnL, which is the mono sum
+\param yn the numTankOutputs tank outputs (wet only)
+*/
+void PluginCore::processTankEngine(double xnL, double xnR, double* yn)
+{
+	if (trueStereoEngineActive)
+		processTrueStereoTank(xnL, xnR, yn);
+	else if (fdnEngineActive)
+		processFDNTank(xnL, yn);
+	else
+		processTank(xnL, yn);
+}
+
+/**
+\brief one sample (at engineSampleRate) through the pre-delay, input diffusers and the figure-eight tank
+
+\param xn the tank input
+\param yn the numTankOutputs tank outputs (wet only)
+*/
+void PluginCore::processTank(double xn, double* yn)
+{
+	double pre = preDelay.processAudioSample(xn);
+	double lp1 = LPF[0].processAudioSample(pre);
+	processTankLoop(inputDiffuser.processAudioSample(lp1), yn);
+}
+
+/**
+\brief one sample (at engineSampleRate) through the figure-eight tank; the input has already been through the
+pre-delay, the input LPF and the diffusers (per sample in processTank( ), per block in processDiffuserBlock( ))
+
+\param diffused the diffuser output
+\param yn the numTankOutputs tank outputs (wet only): L and R from the stereo taps, the rest from readSurroundTaps( )
+*/
+void PluginCore::processTankLoop(double diffused, double* yn)
+{
+	// --- tiny DC at the tank feedback nodes keeps the decaying tail out of denormal range
+	const double antiDenormal = enableAntiDenormal ? kAntiDenormalOffset : 0.0;
+
+	x1 = diffused;
+	double sumX1X2 = x1 + x3 + antiDenormal;
+	double mod1 = modAPF1.processAudioSample(sumX1X2);
+	double del1 = delay1.processAudioSample(mod1);
+	double LP2 = LPF[1].processAudioSample(del1);
+	double AP5 = apf5.processAudioSample(LP2);
+	double del2 = delay2.processAudioSample(AP5);
+	x2 = del2;
+	x2 *= G;
+	x2 += antiDenormal;
+	double mod2 = modAPF2.processAudioSample(x2);
+	double del3 = delay3.processAudioSample(mod2);
+	double LP3 = LPF[2].processAudioSample(del3);
+	double AP6 = apf6.processAudioSample(LP3);
+	double del4 = delay4.processAudioSample(AP6);
+	x3 = del4;
+	x3 *= G;
+	double a1 = delay1.readDelayAtTime_mSec(394/44.1);
+	double a2 = delay1.readDelayAtTime_mSec(4401/44.1);
+	double a3 = delay1.readDelayAtTime_mSec(3124/44.1);
+	double b1 = apf5.readDelay(2831/44.1);
+	double b2 = apf5.readDelay(496/44.1);
+	double c1 = delay2.readDelayAtTime_mSec(2954/44.1);
+	double c2 = delay2.readDelayAtTime_mSec(179/44.1);
+	double d1 = delay3.readDelayAtTime_mSec(2945/44.1);
+	double d2 = delay3.readDelayAtTime_mSec(522/44.1);
+	double d3 = delay3.readDelayAtTime_mSec(5368/44.1);
+	double e1 = apf6.readDelay(277/44.1);
+	double e2 = apf6.readDelay(1817/44.1);
+	double f1 = delay4.readDelayAtTime_mSec(1578/44.1);
+	double f2 = delay4.readDelayAtTime_mSec(3956/44.1);
+
+	yn[0] = a1 + a2 - b1 + c1 - d1 - e1 - f1;
+	yn[1] = d2 + d3 - e2 + f2 - a3 - b2 - c2;
+	if (numTankOutputs > 2)
+		readSurroundTaps(yn);
+}
+
+/**
+\brief one sample (at engineSampleRate) through the true stereo engine: both lanes through the pre-delay and
+input LPF, each through its own diffusers, then the two-lane tank
+
+\param xnL left tank input
+\param xnR right tank input
+\param yn the numTankOutputs tank outputs (wet only)
+*/
+void PluginCore::processTrueStereoTank(double xnL, double xnR, double* yn)
+{
+	double xn[NUM_STEREO_LANES] = { xnL, xnR };
+	stereoPreDelay.processAudioLanes(xn, xn);
+	stereoLPF[0].processAudioLanes(xn, xn);
+	xn[0] = inputDiffuser.processAudioSample(xn[0]);
+	xn[1] = rightInputDiffuser.processAudioSample(xn[1]);
+	processTrueStereoTankLoop(xn, yn);
+}
+
+/**
+\brief one sample (at engineSampleRate) through two figure-eight tanks, one per lane, with the same math as
+processTankLoop( ); the x3 feedback is rotated between the lanes by the cross-feed angle
+
+Operation:
+- the left output uses the left taps of the left lane's tank, the right output the right taps of the right lane's,
+  so with equal inputs and no cross-feed this is exactly the plate
+
+\param diffused the diffuser outputs, one per lane
+\param yn the numTankOutputs tank outputs (wet only)
+*/
+void PluginCore::processTrueStereoTankLoop(const double* diffused, double* yn)
+{
+	// --- tiny DC at the tank feedback nodes keeps the decaying tail out of denormal range
+	const double antiDenormal = enableAntiDenormal ? kAntiDenormalOffset : 0.0;
+
+	double feedback[NUM_STEREO_LANES] = { stereoX3[0], stereoX3[1] };
+	if (crossFeedSin != 0.0)
+	{
+		feedback[0] = crossFeedCos*stereoX3[0] + crossFeedSin*stereoX3[1];
+		feedback[1] = crossFeedCos*stereoX3[1] - crossFeedSin*stereoX3[0];
+	}
+
+	double x[NUM_STEREO_LANES];
+	for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+		x[i] = diffused[i] + feedback[i] + antiDenormal;
+	stereoModAPF[0].processAudioLanes(x, x);
+	stereoDelay[0].processAudioLanes(x, x);
+	stereoLPF[1].processAudioLanes(x, x);
+	stereoAPF[0].processAudioLanes(x, x);
+	stereoDelay[1].processAudioLanes(x, x);
+	for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+		x[i] = x[i]*G + antiDenormal;
+	stereoModAPF[1].processAudioLanes(x, x);
+	stereoDelay[2].processAudioLanes(x, x);
+	stereoLPF[2].processAudioLanes(x, x);
+	stereoAPF[1].processAudioLanes(x, x);
+	stereoDelay[3].processAudioLanes(x, x);
+	for (unsigned int i = 0; i < NUM_STEREO_LANES; i++)
+		stereoX3[i] = x[i]*G;
+
+	double a1 = stereoDelay[0].readLaneAtTime_mSec(394/44.1, 0);
+	double a2 = stereoDelay[0].readLaneAtTime_mSec(4401/44.1, 0);
+	double b1 = stereoAPF[0].readDelay(2831/44.1, 0);
+	double c1 = stereoDelay[1].readLaneAtTime_mSec(2954/44.1, 0);
+	double d1 = stereoDelay[2].readLaneAtTime_mSec(2945/44.1, 0);
+	double e1 = stereoAPF[1].readDelay(277/44.1, 0);
+	double f1 = stereoDelay[3].readLaneAtTime_mSec(1578/44.1, 0);
+
+	double a3 = stereoDelay[0].readLaneAtTime_mSec(3124/44.1, 1);
+	double b2 = stereoAPF[0].readDelay(496/44.1, 1);
+	double c2 = stereoDelay[1].readLaneAtTime_mSec(179/44.1, 1);
+	double d2 = stereoDelay[2].readLaneAtTime_mSec(522/44.1, 1);
+	double d3 = stereoDelay[2].readLaneAtTime_mSec(5368/44.1, 1);
+	double e2 = stereoAPF[1].readDelay(1817/44.1, 1);
+	double f2 = stereoDelay[3].readLaneAtTime_mSec(3956/44.1, 1);
+
+	yn[0] = a1 + a2 - b1 + c1 - d1 - e1 - f1;
+	yn[1] = d2 + d3 - e2 + f2 - a3 - b2 - c2;
+	if (numTankOutputs > 2)
+		readSurroundTaps(yn);
+}
+
+/**
+\brief the surround tank outputs (yn[2] up to numTankOutputs), each from its own tap set on the tank lines
+
+Operation:
+- the tap sets come from kSurroundTapTimes; sets that start in the right half of the tank read the right lane of
+  the true stereo engine, the others the left lane, and C takes both lanes
+
+\param yn the tank outputs; L and R are already there
+*/
+void PluginCore::readSurroundTaps(double* yn)
+{
+	for (uint32_t i = 2; i < numTankOutputs; i++)
+	{
+		const double* tapTimes = kSurroundTapTimes[i - 2];
+		bool rightHalf = kSurroundTapSetRightHalf[i - 2];
+		if (trueStereoEngineActive && i == kCenterTankOutput)
+			yn[i] = 0.5*(readTankTapSet(tapTimes, rightHalf, 0) + readTankTapSet(tapTimes, rightHalf, 1));
+		else
+			yn[i] = readTankTapSet(tapTimes, rightHalf, rightHalf ? 1 : 0);
+	}
+}
+
+/**
+\brief one tank output from seven taps, with the same shape and signs as the stereo outputs of processTankLoop( )
+
+\param tapTimes seven tap times in samples at 44.1kHz: two on the first line, then one on each line after it; each
+shorter than its line (kSurroundTapTimes is checked against kTankLineLength at compile time)
+\param rightHalf start on delay3 (right half of the figure-eight) rather than on delay1
+\param lane true stereo engine lane to read
+
+\return the tank output (wet only)
+*/
+double PluginCore::readTankTapSet(const double* tapTimes, bool rightHalf, unsigned int lane)
+{
+	// --- lines in order around the tank: delay1, apf5, delay2, delay3, apf6, delay4
+	uint32_t first = rightHalf ? 3 : 0;
+	return readTankLine(first, tapTimes[0], lane) + readTankLine(first, tapTimes[1], lane)
+		- readTankLine(first + 1, tapTimes[2], lane) + readTankLine(first + 2, tapTimes[3], lane)
+		- readTankLine((first + 3) % kNumTankLines, tapTimes[4], lane) - readTankLine((first + 4) % kNumTankLines, tapTimes[5], lane)
+		- readTankLine((first + 5) % kNumTankLines, tapTimes[6], lane);
+}
+
+/**
+\brief read a tank line of the active plate engine
+
+\param line index around the tank: delay1, apf5, delay2, delay3, apf6, delay4
+\param tap_Samples tap time in samples at 44.1kHz
+\param lane true stereo engine lane to read; ignored by the plate
+
+\return the delayed sample
+*/
+double PluginCore::readTankLine(uint32_t line, double tap_Samples, unsigned int lane)
+{
+	double tap_mSec = tap_Samples / 44.1;
+	if (trueStereoEngineActive)
+	{
+		switch (line)
+		{
+			case 0: return stereoDelay[0].readLaneAtTime_mSec(tap_mSec, lane);
+			case 1: return stereoAPF[0].readDelay(tap_mSec, lane);
+			case 2: return stereoDelay[1].readLaneAtTime_mSec(tap_mSec, lane);
+			case 3: return stereoDelay[2].readLaneAtTime_mSec(tap_mSec, lane);
+			case 4: return stereoAPF[1].readDelay(tap_mSec, lane);
+			default: return stereoDelay[3].readLaneAtTime_mSec(tap_mSec, lane);
+		}
+	}
+
+	switch (line)
+	{
+		case 0: return delay1.readDelayAtTime_mSec(tap_mSec);
+		case 1: return apf5.readDelay(tap_mSec);
+		case 2: return delay2.readDelayAtTime_mSec(tap_mSec);
+		case 3: return delay3.readDelayAtTime_mSec(tap_mSec);
+		case 4: return apf6.readDelay(tap_mSec);
+		default: return delay4.readDelayAtTime_mSec(tap_mSec);
+	}
+}
+
+/**
+\brief one sample (at engineSampleRate) through the pre-delay and input LPF into the FDN; replaces the diffusers and the tank
+
+\param xn the tank input
+\param yn the numTankOutputs FDN outputs (wet only); the lines are shared out between them
+*/
+void PluginCore::processFDNTank(double xn, double* yn)
+{
+	double pre = preDelay.processAudioSample(xn);
+	double lp1 = LPF[0].processAudioSample(pre);
+	if (numTankOutputs == 2)
+		fdn.processFDN(lp1, lp1, yn[0], yn[1]);
+	else
+		fdn.processFDN(lp1, lp1, yn, numTankOutputs);
+}
+
+/**
+\brief set up the plate for a pair of channel formats; the layout is cached, so this can be called every buffer
+
+Operation:
+- stereo out: the stereo plate, from mono or stereo in
+- 5.0, 5.1 and 7.1 (SDDS and DTS) out: the tank renders a tap set per output channel (L, R, C, Ls, Rs and the 7.1 pair);
+  LFE gets no reverb, only its dry signal
+- channels are in VST3 speaker order: L R C (LFE) Ls Rs, then the 7.1 pair: Sl Sr for DTS, the Lc Rc front centers for SDDS
+- a surround input (same layout as the output) is folded into the left and right tank inputs: L and R at unity, C into
+  both and the surrounds into their own side at kSurroundFoldDownGain, LFE left out; each output gets its own channel dry
+- SDDS has its own table: Lc and Rc sit between L or R and C, so they are panned there (kFrontCenterFoldGain into their
+  own side, kFrontCenterCrossFoldGain into the other) rather than folded like the DTS side pair
+- mono and stereo inputs feed the tank as they do for stereo out, and only L and R get the dry signal
+- a change in the number of tank outputs re-initializes the resampling filters
+
+\param inputFormat input channelFormat
+\param outputFormat output channelFormat
+
+\return true if the plate runs for these formats
+*/
+bool PluginCore::setPlateChannelLayout(uint32_t inputFormat, uint32_t outputFormat)
+{
+	if (inputFormat == layoutInputFormat && outputFormat == layoutOutputFormat)
+		return plateLayoutValid;
+
+	// --- tank output of each channel
+	static const int32_t stereoChannels[2] = { 0, 1 };
+	static const int32_t surround5p0Channels[5] = { 0, 1, 2, 3, 4 };
+	static const int32_t surround5p1Channels[6] = { 0, 1, 2, kNoPlateChannel, 3, 4 };
+	static const int32_t surround7p1Channels[8] = { 0, 1, 2, kNoPlateChannel, 3, 4, 5, 6 };
+	static const int32_t surround7p1SDDSChannels[8] = { 0, 1, 2, kNoPlateChannel, 3, 4, 5, 6 };
+
+	const int32_t* outputChannels = nullptr;
+	uint32_t tankOutputs = 0;
+	switch (outputFormat)
+	{
+		case kCFStereo: outputChannels = stereoChannels; tankOutputs = 2; break;
+		case kCF5p0: outputChannels = surround5p0Channels; tankOutputs = 5; break;
+		case kCF5p1: outputChannels = surround5p1Channels; tankOutputs = 5; break;
+		case kCF7p1Sony: outputChannels = surround7p1SDDSChannels; tankOutputs = 7; break;
+		case kCF7p1DTS: outputChannels = surround7p1Channels; tankOutputs = 7; break;
+		default: break;
+	}
+
+	layoutInputFormat = inputFormat;
+	layoutOutputFormat = outputFormat;
+	plateLayoutValid = outputChannels != nullptr &&
+		(inputFormat == kCFMono || inputFormat == kCFStereo || inputFormat == outputFormat);
+	if (!plateLayoutValid)
+		return false;
+
+	numPlateInputChannels = pluginDescriptor.getChannelCountForChannelIOConfig(inputFormat);
+	numPlateOutputChannels = pluginDescriptor.getChannelCountForChannelIOConfig(outputFormat);
+	const int32_t* inputChannels = inputFormat == outputFormat ? outputChannels : stereoChannels;
+
+	for (uint32_t i = 0; i < numPlateInputChannels; i++)
+	{
+		int32_t tankOutput = inputFormat == kCFMono ? kNoPlateChannel : inputChannels[i];
+		switch (tankOutput)
+		{
+			case kNoPlateChannel:
+			{
+				// --- mono: both tank inputs; LFE: neither
+				double gain = inputFormat == kCFMono ? 1.0 : 0.0;
+				inputFoldLeft[i] = gain;
+				inputFoldRight[i] = gain;
+				break;
+			}
+			case 0: inputFoldLeft[i] = 1.0; inputFoldRight[i] = 0.0; break;
+			case 1: inputFoldLeft[i] = 0.0; inputFoldRight[i] = 1.0; break;
+			case kCenterTankOutput: inputFoldLeft[i] = inputFoldRight[i] = kSurroundFoldDownGain; break;
+			default:
+			{
+				// --- Ls (3) and the 7.1 left channel (5) are odd tank outputs, Rs (4) and the 7.1 right channel (6) even
+				bool left = (tankOutput & 1) == 1;
+				bool frontCenter = inputChannels == surround7p1SDDSChannels && tankOutput >= (int32_t)kSurroundPairTankOutput;
+				double ownGain = frontCenter ? kFrontCenterFoldGain : kSurroundFoldDownGain;
+				double crossGain = frontCenter ? kFrontCenterCrossFoldGain : 0.0;
+				inputFoldLeft[i] = left ? ownGain : crossGain;
+				inputFoldRight[i] = left ? crossGain : ownGain;
+				break;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < numPlateOutputChannels; i++)
+	{
+		plateOutputTank[i] = outputChannels[i];
+		if (inputFormat == outputFormat)
+			plateDryInput[i] = (int32_t)i;
+		else if (outputChannels[i] == 0)
+			plateDryInput[i] = 0;
+		else if (outputChannels[i] == 1)
+			plateDryInput[i] = (int32_t)numPlateInputChannels - 1;
+		else
+			plateDryInput[i] = kNoPlateChannel;
+	}
+
+	if (tankOutputs != numTankOutputs)
+	{
+		numTankOutputs = tankOutputs;
+		initResamplingFilters(audioProcDescriptor.sampleRate);
+	}
+	return true;
+}
+
+/**
+\brief one frame through the plate for a surround layout (see setPlateChannelLayout( ))
+
+\param input numPlateInputChannels input samples
+\param output numPlateOutputChannels output samples
+*/
+void PluginCore::processSurroundFrame(const double* input, double* output)
+{
+	double xnL = 0.0;
+	double xnR = 0.0;
+	for (uint32_t i = 0; i < numPlateInputChannels; i++)
+	{
+		xnL += inputFoldLeft[i] * input[i];
+		xnR += inputFoldRight[i] * input[i];
+	}
+
+	double yn[kMaxTankOutputs];
+	processPlate(xnL, xnR, yn);
+
+	double wet = (wet_mix / 100);
+	double dry = (1 - wet_mix / 100);
+	for (uint32_t i = 0; i < numPlateOutputChannels; i++)
+	{
+		double wetOut = plateOutputTank[i] == kNoPlateChannel ? 0.0 : yn[plateOutputTank[i]];
+		double dryIn = plateDryInput[i] == kNoPlateChannel ? 0.0 : processDryDelay(i, input[plateDryInput[i]]);
+		output[i] = wetOut * wet + dryIn * dry;
+	}
+}
+
+/**
+\brief render one scheduler sub-block straight from the host buffers
+
+Operation:
+- FX mono-in or stereo-in to stereo-out, and the surround layouts (see setPlateChannelLayout( )); everything else goes
+  through the frame loop
+- VST3 kSample64 buffers are read and written as double, so a 64-bit host never sees a float round trip;
+  32-bit buffers get exactly the same math as processAudioFrame( )
+
+\param processBufferInfo structure of information about *buffer* processing
+\param startFrame first frame of the sub-block
+\param numFrames sub-block length
+
+\return true if the sub-block was rendered, false to fall back to the frame loop
+*/
+bool PluginCore::processAudioSubBlock(ProcessBufferInfo& processBufferInfo, uint32_t startFrame, uint32_t numFrames)
+{
+	if (getPluginType() != kFXPlugin ||
+		!setPlateChannelLayout(processBufferInfo.channelIOConfig.inputChannelFormat, processBufferInfo.channelIOConfig.outputChannelFormat))
+		return false;
+
+	if (processBufferInfo.channelIOConfig.outputChannelFormat != kCFStereo)
+	{
+		if (processBufferInfo.outputs64)
+			processSurroundBlock<double>(processBufferInfo.inputs64, processBufferInfo.outputs64, startFrame, numFrames);
+		else
+			processSurroundBlock<float>(processBufferInfo.inputs, processBufferInfo.outputs, startFrame, numFrames);
+		return true;
+	}
+
+	bool stereoIn = processBufferInfo.channelIOConfig.inputChannelFormat == kCFStereo;
+	if (!stereoIn && processBufferInfo.channelIOConfig.inputChannelFormat != kCFMono)
+		return false;
+
+	if (processBufferInfo.outputs64)
+		processPlateBlock<double>(processBufferInfo.inputs64, processBufferInfo.outputs64, stereoIn, startFrame, numFrames);
+	else
+		processPlateBlock<float>(processBufferInfo.inputs, processBufferInfo.outputs, stereoIn, startFrame, numFrames);
+
+	return true;
+}
+
+/**
+\brief buffer processing with tail-aware sleep
+
+Operation:
+- while the tank is awake, use the base class frame loop (processAudioFrame)
+- once the input and the tank have been below kTankSilenceThreshold for samplesToSleep samples,
+  go to sleep: output zeros and flush one delay object per buffer so there is no large memset spike
+- an engine switch flushes the same way, awake, once the old engine has faded out (see UpdateParameters( ))
+- any input above the threshold wakes the tank up again in the same buffer
+- while asleep every output channel is flagged silent (processBufferInfo.outputSilenceFlags) so the host and downstream
+  plugins can skip our buffers; silent input flags from the host let us decide that without scanning the input
+
+\param processBufferInfo structure of information about *buffer* processing
+
+\return true if operation succeeds, false otherwise
+*/
+bool PluginCore::processAudioBuffers(ProcessBufferInfo& processBufferInfo)
+{
+	// --- test builds: the asleep path is audio thread code too
+	ScopedRealTimeSection realTimeSection;
+
+	// --- mono->mono is a pass-through with no tail, and synths are not handled here
+	bool hasTank = getPluginType() == kFXPlugin &&
+		setPlateChannelLayout(processBufferInfo.channelIOConfig.inputChannelFormat, processBufferInfo.channelIOConfig.outputChannelFormat);
+
+	if (tankAsleep && (!hasTank || !inputIsSilent(processBufferInfo)))
+	{
+		tankAsleep = false;
+		quietSampleCount = 0;
+	}
+
+	processBufferInfo.outputSilenceFlags = 0;
+
+	if (!tankAsleep)
+	{
+		bool processed = PluginBase::processAudioBuffers(processBufferInfo);
+
+		// --- engine switch: the old engine has faded out; one tank object per buffer, then the new engine starts
+		if (tankSwitchPending && tankFadeSamples == 0 && !flushNextTankObject())
+		{
+			tankFlushed = true;
+			completeTankSwitch();
+		}
+
+		// --- trackTankSilence( ) has been counting quiet samples during the frame loop
+		if (hasTank && quietSampleCount >= samplesToSleep)
+		{
+			tankAsleep = true;
+			flushIndex = 0;
+		}
+		return processed;
+	}
+
+	// --- asleep: keep parameters synced (automation jumps to its last points), output silence, clear out the residual tail
+	processTimer.beginBlock(processBufferInfo.numFramesToProcess, audioProcDescriptor.sampleRate);
+	preProcessAudioBuffers(processBufferInfo);
+	beginSampleAccurateAutomation(processBufferInfo.numFramesToProcess);
+	endSampleAccurateAutomation();
+	processTimer.endStage(kPreProcessStage);
+
+	for (uint32_t i = 0; i < processBufferInfo.numAudioOutChannels; i++)
+	{
+		if (processBufferInfo.outputs64)
+			memset(processBufferInfo.outputs64[i], 0, processBufferInfo.numFramesToProcess * sizeof(double));
+		else
+			memset(processBufferInfo.outputs[i], 0, processBufferInfo.numFramesToProcess * sizeof(float));
+		if (i < 64)
+			processBufferInfo.outputSilenceFlags |= (uint64_t)1 << i;
+	}
+
+	if (!flushNextTankObject())
+	{
+		tankFlushed = true;
+		completeTankSwitch();
+	}
+	processTimer.endStage(kFrameLoopStage);
+
+	postProcessAudioBuffers(processBufferInfo);
+	processTimer.endStage(kPostProcessStage);
+	processTimer.endBlock();
+
+	return true;
+}
+
+/**
+\brief test a buffer of input audio against kTankSilenceThreshold
+
+\param processBufferInfo structure of information about *buffer* processing
+
+\return true if every input sample is below the silence threshold (or the host has flagged every input channel silent)
+*/
+bool PluginCore::inputIsSilent(ProcessBufferInfo& processBufferInfo)
+{
+	// --- VST3 silence flags: the host already knows, no need to look at the samples
+	uint32_t numChannels = processBufferInfo.numAudioInChannels;
+	uint64_t allChannels = numChannels >= 64 ? ~(uint64_t)0 : ((uint64_t)1 << numChannels) - 1;
+	if (numChannels > 0 && (processBufferInfo.inputSilenceFlags & allChannels) == allChannels)
+		return true;
+
+	for (uint32_t i = 0; i < processBufferInfo.numAudioInChannels; i++)
+	{
+		for (uint32_t frame = 0; frame < processBufferInfo.numFramesToProcess; frame++)
+		{
+			double xn = processBufferInfo.inputs64 ? processBufferInfo.inputs64[i][frame] : processBufferInfo.inputs[i][frame];
+			if (fabs(xn) >= kTankSilenceThreshold)
+				return false;
+		}
+	}
+	return true;
+}
+
+/**
+\brief count consecutive samples where the tank input, feedback node and outputs are all below threshold
+
+\param xn the tank input (post mono sum; the larger of the two for the true stereo engine)
+\param yL left tank output
+\param yR right tank output
+*/
+void PluginCore::trackTankSilence(double xn, double yL, double yR)
+{
+	if (fabs(xn) < kTankSilenceThreshold && fabs(x3) < kTankSilenceThreshold &&
+		fabs(stereoX3[0]) < kTankSilenceThreshold && fabs(stereoX3[1]) < kTankSilenceThreshold &&
+		fabs(yL) < kTankSilenceThreshold && fabs(yR) < kTankSilenceThreshold)
+	{
+		if (quietSampleCount < samplesToSleep)
+			quietSampleCount++;
+	}
+	else
+		quietSampleCount = 0;
+}
+
+/**
+\brief flush one delay object per call; spreads the cost of clearing the tank over several buffers
+
+\return false once everything has been flushed
+*/
+bool PluginCore::flushNextTankObject()
+{
+	switch (flushIndex)
+	{
+		case 0: preDelay.flushDelay(); break;
+		case 1: inputDiffuser.flushDelays(); break;
+		case 2: modAPF1.flushDelay(); break;
+		case 3: delay1.flushDelay(); break;
+		case 4: apf5.flushDelay(); break;
+		case 5: delay2.flushDelay(); break;
+		case 6: modAPF2.flushDelay(); break;
+		case 7: delay3.flushDelay(); break;
+		case 8: apf6.flushDelay(); break;
+		case 9: delay4.flushDelay(); break;
+		case 10: fdn.flushDelays(); break;
+		case 11: stereoPreDelay.flushDelay(); break;
+		case 12: rightInputDiffuser.flushDelays(); break;
+		case 13: stereoModAPF[0].flushDelay(); break;
+		case 14: stereoDelay[0].flushDelay(); break;
+		case 15: stereoAPF[0].flushDelay(); break;
+		case 16: stereoDelay[1].flushDelay(); break;
+		case 17: stereoModAPF[1].flushDelay(); break;
+		case 18: stereoDelay[2].flushDelay(); break;
+		case 19: stereoAPF[1].flushDelay(); break;
+		case 20: stereoDelay[3].flushDelay(); break;
+		case 21:
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				LPF[i].reset(engineSampleRate);
+				stereoLPF[i].reset(engineSampleRate);
+			}
+			x1 = x2 = x3 = 0.0;
+			stereoX3[0] = stereoX3[1] = 0.0;
+			break;
+		}
+		default: return false; /// all done
+	}
+	flushIndex++;
+	return true;
+}
 
 /**
 \brief do anything needed prior to arrival of audio buffers
@@ -577,16 +1647,18 @@ bool PluginCore::postUpdatePluginParameter(int32_t controlID, double controlValu
     // --- now do any post update cooking; be careful with VST Sample Accurate automation
     //     If enabled, then make sure the cooking functions are short and efficient otherwise disable it
     //     for the Parameter involved
-    /*switch(controlID)
+    switch(controlID)
     {
-        case 0:
+        case controlID::decay:
         {
+			// --- decay is not smoothed so this only happens on a real change
+			pluginDescriptor.tailTimeInMSec = calculateTailTime_mSec();
             return true;    /// handled
         }
 
         default:
             return false;   /// not handled
-    }*/
+    }
 
     return false;
 }
@@ -746,6 +1818,8 @@ bool PluginCore::initPluginPresets()
 	setPresetParameter(preset->presetParameters, controlID::mod_rate, 0.100000);
 	setPresetParameter(preset->presetParameters, controlID::mod_dpeth, 0.100000);
 	setPresetParameter(preset->presetParameters, controlID::predelay_time, 15.000001);
+	setPresetParameter(preset->presetParameters, controlID::engine, -0.000000);
+	setPresetParameter(preset->presetParameters, controlID::cross_feed, 25.000000);
 	addPreset(preset);
 
 
@@ -45,7 +45,7 @@ const bool kWantSidechain = false;
 const uint32_t kLatencyInSamples = 0;
 const double kTailTimeMsec = 0.000000;
 const bool kVSTInfiniteTail = false;
-const bool kVSTSAA = false;
+const bool kVSTSAA = true;
 const uint32_t kVST3SAAGranularity = 1;
 const uint32_t kAAXCategory = aaxPlugInCategory_None;
 
@@ -112,13 +112,208 @@ namespace VSTGUI
 
 const bool ENABLE_CUSTOM_VIEWS = true;
 
+/**
+\brief the process-wide cache map (function-local static so it is constructed on first use)
+*/
+std::map<std::string, UIDescriptionCache::CacheEntry>& UIDescriptionCache::getCache()
+{
+	static std::map<std::string, CacheEntry> cache;
+	return cache;
+}
+
+/**
+\brief the process-wide keep-alive flag
+*/
+bool& UIDescriptionCache::getKeepAlive()
+{
+	static bool keepAlive = false;
+	return keepAlive;
+}
+
+/**
+\brief get the parsed description for a file; parses the XML only on the first request
+
+\param xmlFile the XML file name, exactly as passed to PluginGUI
+
+\return a remember( )-ed UIDescription, or nullptr if the file could not be parsed
+*/
+UIDescription* UIDescriptionCache::getDescription(UTF8StringPtr xmlFile)
+{
+	std::map<std::string, CacheEntry>& cache = getCache();
+	std::string key(xmlFile ? xmlFile : "");
+
+	std::map<std::string, CacheEntry>::iterator it = cache.find(key);
+	if (it == cache.end())
+	{
+		UIDescription* description = new UIDescription(xmlFile);
+		if (!description->parse())
+		{
+			description->forget();
+			return nullptr;
+		}
+		it = cache.insert(std::make_pair(key, CacheEntry())).first;
+		it->second.description = description; // --- cache owns this reference
+	}
+
+	it->second.users++;
+	it->second.description->remember(); // --- caller's reference
+	return it->second.description;
+}
+
+/**
+\brief an editor is done with a shared description; drop the cache entry if nobody needs it
+
+\param description the description from getDescription( )
+*/
+void UIDescriptionCache::releaseDescription(UIDescription* description)
+{
+	std::map<std::string, CacheEntry>& cache = getCache();
+	for (std::map<std::string, CacheEntry>::iterator it = cache.begin(); it != cache.end(); ++it)
+	{
+		if (it->second.description != description)
+			continue;
+
+		if (it->second.users > 0)
+			it->second.users--;
+
+		if (it->second.users == 0 && !getKeepAlive())
+		{
+			it->second.description->forget();
+			cache.erase(it);
+		}
+		return;
+	}
+}
+
+/**
+\brief remove a file from the cache; editors already using it keep their reference
+
+\param xmlFile the XML file name
+*/
+void UIDescriptionCache::invalidate(UTF8StringPtr xmlFile)
+{
+	std::map<std::string, CacheEntry>& cache = getCache();
+	std::map<std::string, CacheEntry>::iterator it = cache.find(std::string(xmlFile ? xmlFile : ""));
+	if (it == cache.end())
+		return;
+
+	it->second.description->forget();
+	cache.erase(it);
+}
+
+/**
+\brief keep parsed descriptions when no editor is open; turning it off releases entries with no users
+
+\param keepAlive the flag
+*/
+void UIDescriptionCache::setKeepAlive(bool keepAlive)
+{
+	getKeepAlive() = keepAlive;
+	if (keepAlive)
+		return;
+
+	std::map<std::string, CacheEntry>& cache = getCache();
+	for (std::map<std::string, CacheEntry>::iterator it = cache.begin(); it != cache.end();)
+	{
+		if (it->second.users == 0)
+		{
+			it->second.description->forget();
+			it = cache.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+/**
+\brief the process-wide bitmap map (function-local static so it is constructed on first use)
+*/
+std::map<std::string, CBitmap*>& BitmapCache::getCache()
+{
+	static std::map<std::string, CBitmap*> cache;
+	return cache;
+}
+
+/**
+\brief the process-wide keep-alive flag
+*/
+bool& BitmapCache::getKeepAlive()
+{
+	static bool keepAlive = false;
+	return keepAlive;
+}
+
+/**
+\brief get a decoded bitmap, decoding the resource only on the first request for this name and scale
+
+\param resourceName the resource (file) name, e.g. "knob.png"
+\param scaleFactor the scale the resource was drawn at (2.0 for a hi-DPI strip); 1.0 for normal resources
+
+\return a remember( )-ed CBitmap; the caller forget( )s it when done, as with new CBitmap( )
+*/
+CBitmap* BitmapCache::getBitmap(UTF8StringPtr resourceName, double scaleFactor)
+{
+	std::map<std::string, CBitmap*>& cache = getCache();
+
+	std::ostringstream key;
+	key << (resourceName ? resourceName : "") << "@" << scaleFactor;
+
+	std::map<std::string, CBitmap*>::iterator it = cache.find(key.str());
+	if (it == cache.end())
+	{
+		CBitmap* bitmap = new CBitmap(CResourceDescription(resourceName)); // --- cache owns this reference
+		if (scaleFactor != 1.0 && bitmap->getPlatformBitmap())
+			bitmap->getPlatformBitmap()->setScaleFactor(scaleFactor);
+
+		it = cache.insert(std::make_pair(key.str(), bitmap)).first;
+	}
+
+	it->second->remember(); // --- caller's reference
+	return it->second;
+}
+
+/**
+\brief release bitmaps that only the cache is still holding (unless keep-alive is set)
+
+Operation:\n
+- called when an editor closes, after its views have released their bitmaps
+*/
+void BitmapCache::releaseUnused()
+{
+	if (getKeepAlive())
+		return;
+
+	std::map<std::string, CBitmap*>& cache = getCache();
+	for (std::map<std::string, CBitmap*>::iterator it = cache.begin(); it != cache.end();)
+	{
+		if (it->second->getNbReference() <= 1)
+		{
+			it->second->forget();
+			it = cache.erase(it);
+		}
+		else
+			++it;
+	}
+}
+
+/**
+\brief keep decoded bitmaps when no editor is open; turning it off releases the unused ones
+
+\param keepAlive the flag
+*/
+void BitmapCache::setKeepAlive(bool keepAlive)
+{
+	getKeepAlive() = keepAlive;
+	releaseUnused();
+}
+
 /**
 \brief PluginGUI constructor; note that this maintains both Mac and Windows contexts, the bundle ref for Mac
 and the external void* for Windows.
 
 Operation: \n
-- creates UIDescription from the XML file; stores both the file and the description object (they get used or written later)
-- calls description->parse() to convert XML into objects
+- gets the UIDescription for the XML file from UIDescriptionCache; stores both the file and the description object (they get used or written later)
+- the XML is parsed (description->parse()) only if no other editor in this process has already done it
 - initializes main attributes
 - sets up the GUI timer for a 50 millisecond repaint interval
 */
@@ -143,14 +338,10 @@ PluginGUI::PluginGUI(UTF8StringPtr _xmlFile) :
     m_AU = nullptr;
 #endif
 
-	// --- create description from XML file
+	// --- get the description; the XML is only parsed by the first editor to open in this process
 	xmlFile = _xmlFile;
-	description = new UIDescription(_xmlFile);
-	if (!description->parse())
-	{
-		description->forget();
-		description = nullptr;
-	}
+	description = UIDescriptionCache::getDescription(_xmlFile);
+	sharedDescription = description != nullptr;
 
     // --- set attributes
     guiPluginConnector = nullptr;
@@ -179,7 +370,11 @@ PluginGUI::~PluginGUI()
 {
 	// --- destroy description
 	if (description)
+	{
+		if (sharedDescription)
+			UIDescriptionCache::releaseDescription(description);
 		description->forget();
+	}
 
 	// --- kill timer
 	if (timer)
@@ -352,6 +547,9 @@ void PluginGUI::close()
         CFrame* oldFrame = frame;
         frame = 0;
         oldFrame->forget();
+
+		// --- views are gone; let go of bitmaps no other editor is using
+		BitmapCache::releaseUnused();
     }
 }
 
@@ -628,7 +826,9 @@ void PluginGUI::writeToPresetFile()
 
 Operation:\n
 - send the timer ping message
-- send process loop output data to any output-only receivers (meters)
+- shells that track changes (getGUIParameterChanges): update the controls of the changed parameters only, then
+  repaint the meters that are still animating
+- other shells: send process loop output data to every output-only receiver (meters)
 - issue the repaint message to the outer frame
 */
 void PluginGUI::idle()
@@ -639,15 +839,49 @@ void PluginGUI::idle()
         if(guiPluginConnector)
             guiPluginConnector->guiTimerPing();
 
-        for(std::vector<CControl*>::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
+        // --- dirty list: only touch the controls of parameters that changed, if the shell tracks changes;
+        //     knobs, menus and labels get one update per ping however many times their parameter moved
+        if(guiPluginConnector && guiPluginConnector->getGUIParameterChanges(changedGUIParameters))
         {
-            CControl* ctrl = *it;
-            if(ctrl)
+            for(std::vector<int32_t>::iterator it = changedGUIParameters.begin(); it != changedGUIParameters.end(); ++it)
             {
-                double param = 0.0;
-                if(guiPluginConnector)
+                int32_t tag = *it;
+                float param = (float)guiPluginConnector->getNormalizedPluginParameter(tag);
+
+                // --- the receiver skips meters
+                ControlUpdateReceiver* receiver = getControlUpdateReceiver(tag);
+                if(receiver)
+                    receiver->updateControlsWithNormalizedValue(param);
+
+                std::pair<WriteableControlMap::iterator, WriteableControlMap::iterator> meters = writeableControls.equal_range(tag);
+                for(WriteableControlMap::iterator meter = meters.first; meter != meters.second; ++meter)
                 {
-                    param = guiPluginConnector->getNormalizedPluginParameter(ctrl->getTag());
+                    CControl* ctrl = meter->second;
+                    if(ctrl->getValue() != param)
+                    {
+                        ctrl->setValue(param);
+                        ctrl->invalid();
+                    }
+                }
+            }
+
+            // --- meters animate their falloff in draw( ); keep repainting until it is done
+            for(std::vector<CVuMeterEx*>::iterator it = animatedMeters.begin(); it != animatedMeters.end(); ++it)
+            {
+                CVuMeterEx* meter = *it;
+                if(!meter->isSettled())
+                    meter->invalid();
+            }
+        }
+        else
+        {
+            // --- no change tracking: refresh every meter on every ping
+            for(WriteableControlMap::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
+            {
+                CControl* ctrl = it->second;
+                if(ctrl && guiPluginConnector)
+                {
+                    double param = guiPluginConnector->getNormalizedPluginParameter(ctrl->getTag());
                     ctrl->setValue((float)param);
                     ctrl->invalid();
                 }
@@ -880,6 +1114,11 @@ bool PluginGUI::createGUI(bool bShowGUIEditor)
 #if VSTGUI_LIVE_EDITING
 		if (bShowGUIEditor)
 		{
+			// --- never edit the tree that other editors are sharing
+			makeDescriptionPrivate();
+			if (!description)
+				return false;
+
 			guiEditorFrame->setTransform(CGraphicsTransform());
 			nonEditRect = guiEditorFrame->getViewSize();
 			description->setController((IController*)this);
@@ -1085,6 +1324,33 @@ void PluginGUI::save(bool saveAs)
 
 	// --- save file
 	description->save(savePath.c_str(), flags);
+
+	// --- editors opened from now on must see the saved version
+	UIDescriptionCache::invalidate(xmlFile.c_str());
+}
+
+/**
+\brief replace the shared, cached description with a private parse of the XML file so it can be edited safely
+
+Operation:\n
+- no-op if the description is already private
+*/
+void PluginGUI::makeDescriptionPrivate()
+{
+	if (!sharedDescription)
+		return;
+
+	UIDescription* privateDescription = new UIDescription(xmlFile.c_str());
+	if (!privateDescription->parse())
+	{
+		privateDescription->forget();
+		return; // --- keep the shared one
+	}
+
+	UIDescriptionCache::releaseDescription(description);
+	description->forget();
+	description = privateDescription;
+	sharedDescription = false;
 }
 
 /**
@@ -1915,8 +2181,7 @@ CView* PluginGUI::createView(const UIAttributes& attributes, const IUIDescriptio
         std::string BMString = *bitmapString;
         BMString += ".png";
         UTF8StringPtr bmp = BMString.c_str();
-        CResourceDescription bmpRes(bmp);
-        CBitmap* pBMP = new CBitmap(bmpRes);
+        CBitmap* pBMP = BitmapCache::getBitmap(bmp);
         
         // --- offset
         CPoint offset(0.0, 0.0);
@@ -2024,8 +2289,7 @@ CView* PluginGUI::createView(const UIAttributes& attributes, const IUIDescriptio
         std::string BMString = *bitmapString;
         BMString += ".png";
         UTF8StringPtr bmp = BMString.c_str();
-        CResourceDescription bmpRes(bmp);
-        CBitmap* pBMP = new CBitmap(bmpRes);
+        CBitmap* pBMP = BitmapCache::getBitmap(bmp);
         
         // --- offset
         CPoint offset(0.0, 0.0);
@@ -2144,8 +2408,7 @@ CView* PluginGUI::createView(const UIAttributes& attributes, const IUIDescriptio
         std::string BMString = *bitmapString;
         BMString += ".png";
         UTF8StringPtr bmp = BMString.c_str();
-        CResourceDescription bmpRes(bmp);
-        CBitmap* pBMP = new CBitmap(bmpRes);
+        CBitmap* pBMP = BitmapCache::getBitmap(bmp);
         
         // --- offset
         // --- offset
@@ -2216,14 +2479,12 @@ CView* PluginGUI::createView(const UIAttributes& attributes, const IUIDescriptio
         std::string BMString = *bitmapString;
         BMString += ".png";
         UTF8StringPtr bmp = BMString.c_str();
-        CResourceDescription bmpRes(bmp);
-        CBitmap* pBMP_back = new CBitmap(bmpRes);
+        CBitmap* pBMP_back = BitmapCache::getBitmap(bmp);
         
         std::string BMStringH = *handleBitmapString;
         BMStringH += ".png";
         UTF8StringPtr bmpH = BMStringH.c_str();
-        CResourceDescription bmpResH(bmpH);
-        CBitmap* pBMP_hand = new CBitmap(bmpResH);
+        CBitmap* pBMP_hand = BitmapCache::getBitmap(bmpH);
         
         // --- offset
         CPoint offset(0.0, 0.0);
@@ -2294,14 +2555,12 @@ CView* PluginGUI::createView(const UIAttributes& attributes, const IUIDescriptio
         std::string onBMString = *ONbitmapString;
         onBMString += ".png";
         UTF8StringPtr onbmp = onBMString.c_str();
-        CResourceDescription bmpRes(onbmp);
-        CBitmap* onBMP = new CBitmap(bmpRes);
+        CBitmap* onBMP = BitmapCache::getBitmap(onbmp);
         
         std::string offBMString = *OFFbitmapString;
         offBMString += ".png";
         UTF8StringPtr offbmp = offBMString.c_str();
-        CResourceDescription bmpRes2(offbmp);
-        CBitmap* offBMP = new CBitmap(bmpRes2);
+        CBitmap* offBMP = BitmapCache::getBitmap(offbmp);
         
         int32_t nbLed = strtol(numLEDString->c_str(), 0, 10);
         
@@ -2370,14 +2629,12 @@ CView* PluginGUI::createView(const UIAttributes& attributes, const IUIDescriptio
             std::string onBMString = *ONbitmapString;
             onBMString += ".png";
             UTF8StringPtr onbmp = onBMString.c_str();
-            CResourceDescription bmpRes(onbmp);
-            CBitmap* onBMP = new CBitmap(bmpRes);
+            CBitmap* onBMP = BitmapCache::getBitmap(onbmp);
             
             std::string offBMString = *OFFbitmapString;
             offBMString += ".png";
             UTF8StringPtr offbmp = offBMString.c_str();
-            CResourceDescription bmpRes2(offbmp);
-            CBitmap* offBMP = new CBitmap(bmpRes2);
+            CBitmap* offBMP = BitmapCache::getBitmap(offbmp);
             
             int32_t nbLed = strtol(numLEDString->c_str(), 0, 10);
             
@@ -384,6 +384,80 @@ protected:
 };
 
 
+/**
+\class UIDescriptionCache
+\ingroup ASPiK-GUI
+\brief
+Process-wide cache of parsed UIDescription objects, keyed by XML file name. The first editor to open parses the
+XML (and decodes its base64 bitmaps); every later editor shares that parsed tree and its decoded bitmaps, so opening
+an editor does no XML or image parsing.
+
+Operation:
+- getDescription( ) returns a remember( )-ed description; the caller forget( )s it as usual
+- the cache keeps its own reference while setKeepAlive(true) is in effect (VST3: between InitModule and DeinitModule);
+  otherwise the entry is dropped when the last editor using it closes
+- a PluginGUI that enters the GUI designer switches to a private copy first (see PluginGUI::makeDescriptionPrivate)
+  so that edits never leak into other instances
+- GUI thread only, like the rest of VSTGUI
+*/
+class UIDescriptionCache
+{
+public:
+	/** get the parsed description for a file, parsing it only if it is not cached; nullptr on parse failure */
+	static UIDescription* getDescription(UTF8StringPtr xmlFile);
+
+	/** tell the cache an editor has finished with a description it got from getDescription( ) */
+	static void releaseDescription(UIDescription* description);
+
+	/** drop the cached entry for a file (e.g. after the GUI designer saves it) */
+	static void invalidate(UTF8StringPtr xmlFile);
+
+	/** keep parsed descriptions alive when no editor is open; turning this off releases unused entries */
+	static void setKeepAlive(bool keepAlive);
+
+protected:
+	struct CacheEntry
+	{
+		UIDescription* description = nullptr;	///< parsed description; the cache holds one reference
+		uint32_t users = 0;						///< number of open editors using it
+	};
+
+	static std::map<std::string, CacheEntry>& getCache();	///< the process-wide map
+	static bool& getKeepAlive();							///< the process-wide keep-alive flag
+};
+
+/**
+\class BitmapCache
+\ingroup ASPiK-GUI
+\brief
+Process-wide, reference-counted cache of the decoded bitmaps used by the custom views (knob strips, slider handles,
+meter images), keyed by resource name and scale factor. The first editor decodes each PNG; every later editor
+shares the same pixels.
+
+Operation:
+- getBitmap( ) replaces new CBitmap(CResourceDescription(name)); the caller forget( )s the result as before
+- releaseUnused( ) is called as each editor closes and drops bitmaps held only by the cache
+- setKeepAlive(true) keeps them between editor opens (VST3: between InitModule and DeinitModule)
+- GUI scaling (SCALE_GUI_SIZE) is a frame transform, so one decoded copy serves every zoom setting
+- GUI thread only, like the rest of VSTGUI
+*/
+class BitmapCache
+{
+public:
+	/** get a shared, remember( )-ed bitmap for a resource; decoded only on first use */
+	static CBitmap* getBitmap(UTF8StringPtr resourceName, double scaleFactor = 1.0);
+
+	/** drop bitmaps that no open editor is using (no-op with keep-alive set) */
+	static void releaseUnused();
+
+	/** keep decoded bitmaps alive when no editor is open; turning this off releases unused ones */
+	static void setKeepAlive(bool keepAlive);
+
+protected:
+	static std::map<std::string, CBitmap*>& getCache();	///< the process-wide map; the cache holds one reference per bitmap
+	static bool& getKeepAlive();						///< the process-wide keep-alive flag
+};
+
 /**
 \class PluginGUI
 \ingroup ASPiK-GUI
@@ -494,6 +568,8 @@ protected:
 	// --- protected variables
     IGUIPluginConnector* guiPluginConnector = nullptr; ///< the plugin shell interface that arrives with the open( ) function; OK if NULL for standalone GUIs
 	UIDescription* description = nullptr; ///< the description version of the XML file
+	bool sharedDescription = false;	///< description came from UIDescriptionCache and is shared with other editors
+	void makeDescriptionPrivate();	///< swap a shared description for a private parse (before editing it)
 	std::string viewName;			///< name
 	std::string xmlFile;			///< the XML file name
 
@@ -731,7 +807,12 @@ public:
 	*/
 	bool hasWriteableControl(CControl* control)
     {
-        return std::find (writeableControls.begin (), writeableControls.end (), control) != writeableControls.end ();
+        for(WriteableControlMap::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
+        {
+            if(it->second == control)
+                return true;
+        }
+        return false;
     }
 
 	/**
@@ -750,8 +831,13 @@ public:
             return;
         if(!hasWriteableControl(control))
         {
-            writeableControls.push_back(control);
+            writeableControls.insert(std::make_pair(control->getTag(), control));
             control->remember();
+
+            // --- cast once here, not on every timer ping
+            CVuMeterEx* meter = dynamic_cast<CVuMeterEx*>(control);
+            if(meter)
+                animatedMeters.push_back(meter);
         }
     }
 
@@ -764,9 +850,11 @@ public:
     {
         if(!hasWriteableControl(control)) return;
 
-        for(std::vector<CControl*>::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
+        animatedMeters.erase(std::remove(animatedMeters.begin(), animatedMeters.end(), control), animatedMeters.end());
+
+        for(WriteableControlMap::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
         {
-            CControl* ctrl = *it;
+            CControl* ctrl = it->second;
             if(ctrl == control)
             {
                 ctrl->forget();
@@ -794,12 +882,13 @@ public:
 	*/
 	void forgetWriteableControls()
 	{
-		for (std::vector<CControl*>::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
+		for (WriteableControlMap::iterator it = writeableControls.begin(); it != writeableControls.end(); ++it)
 		{
-			CControl* ctrl = *it;
+			CControl* ctrl = it->second;
 			ctrl->forget();
 		}
         writeableControls.clear();
+        animatedMeters.clear();
 	}
 
 	/**
@@ -835,7 +924,10 @@ public:
 private:
     typedef std::map<int32_t, ControlUpdateReceiver*> ControlUpdateReceiverMap; ///< map of control receivers
     ControlUpdateReceiverMap controlUpdateReceivers;
-    std::vector<CControl*> writeableControls;		///< vector of meters
+    typedef std::multimap<int32_t, CControl*> WriteableControlMap; ///< map of meters, by control tag
+    WriteableControlMap writeableControls;
+    std::vector<CVuMeterEx*> animatedMeters;		///< the writeable controls that animate their falloff (repainted until settled)
+    std::vector<int32_t> changedGUIParameters;		///< control IDs changed since the last timer ping (reused, see idle( ))
     std::vector<PluginParameter*> pluginParameters; ///< local COPY of parameters
 
 #ifdef AAXPLUGIN
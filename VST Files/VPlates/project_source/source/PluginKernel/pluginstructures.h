@@ -20,10 +20,19 @@
 #include <sstream>
 #include <vector>
 #include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
 
 #include "readerwriterqueue.h"
 #include "atomicops.h"
 
+// --- SSE control register for flush-to-zero/denormals-are-zero
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP > 0)
+#include <xmmintrin.h>
+#define HAVE_SSE_MXCSR 1
+#endif
+
 class IGUIPluginConnector;
 class IGUIWindowFrame;
 class IGUIView;
@@ -166,6 +175,16 @@ enum auxGUIIdentifier
 	guiControlData
 };
 
+/**
+\enum hostProcessMode
+\ingroup Constants-Enums
+\brief
+How the host is going to run the plugin; passed in ResetInfo (VST3 ProcessSetup::processMode, real-time for the other APIs).
+
+- kRealtimeProcessMode, kPrefetchProcessMode, kOfflineProcessMode (bounce/export: no deadline, favor quality over CPU)
+*/
+enum hostProcessMode { kRealtimeProcessMode, kPrefetchProcessMode, kOfflineProcessMode };
+
 /**
 \struct ResetInfo
 \ingroup Structures
@@ -190,6 +209,7 @@ struct ResetInfo
 
 	double sampleRate = 0.0;	///< sample rate
 	uint32_t bitDepth = 0;		///< bit depth (not available in all APIs)
+	hostProcessMode processMode = kRealtimeProcessMode;	///< real-time, prefetch or offline (VST3 only)
 };
 
 /**
@@ -1076,6 +1096,12 @@ struct ProcessBufferInfo
 	float** outputs = nullptr;		///< audio output buffers
 	float** auxInputs = nullptr;	///< aux (sidechain) input buffers
 	float** auxOutputs = nullptr;	///< aux outputs - for future use
+
+	// --- VST3 kSample64: the shell sets these instead of the float buffers (outputs64 != nullptr means 64-bit I/O)
+	double** inputs64 = nullptr;		///< 64-bit audio input buffers
+	double** outputs64 = nullptr;		///< 64-bit audio output buffers
+	double** auxInputs64 = nullptr;		///< 64-bit aux (sidechain) input buffers
+	double** auxOutputs64 = nullptr;	///< 64-bit aux outputs - for future use
 	uint32_t numAudioInChannels = 0;		///< audio input channel count
 	uint32_t numAudioOutChannels = 0;		///< audio output channel count
 	uint32_t numAuxAudioInChannels = 0;		///< aux input channel count
@@ -1085,6 +1111,10 @@ struct ProcessBufferInfo
     ChannelIOConfig channelIOConfig;		///< input/output channel I/O configuration pair
     ChannelIOConfig auxChannelIOConfig;		///< aux input/output channel I/O configuration pair
 
+	// --- VST3 silence flags, one bit per channel (bit 0 = channel 0); zero for the other APIs
+	uint64_t inputSilenceFlags = 0;			///< set by the shell: input channels the host reports as silent
+	uint64_t outputSilenceFlags = 0;		///< set by the core: output channels that contain only silence
+
 	// --- for future use, VCVRack
 	float* controlSignalInputs = nullptr;	///< control signals in (reserved for future use)
 	float* controlSignalOutputs = nullptr;	///< control signals out (reserved for future use)
@@ -1102,6 +1132,10 @@ struct ProcessBufferInfo
 \brief
 Information package that arrives with each new audio frame; called internally from the buffer process function.
 
+NOTES:
+- the frames are double so VST3 64-bit (kSample64) buffers reach processAudioFrame( ) without truncation; 32-bit
+  buffers are widened, which is lossless
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -1111,10 +1145,10 @@ struct ProcessFrameInfo
 {
     ProcessFrameInfo(){ }
 
-	float* audioInputFrame = nullptr;		///< audio input frame (array)
-	float* audioOutputFrame = nullptr;		///< audio output frame (array)
-	float* auxAudioInputFrame = nullptr;	///< aux input frame (array)
-	float* auxAudioOutputFrame = nullptr;	///< aux output frame (array) for future use
+	double* audioInputFrame = nullptr;		///< audio input frame (array)
+	double* audioOutputFrame = nullptr;		///< audio output frame (array)
+	double* auxAudioInputFrame = nullptr;	///< aux input frame (array)
+	double* auxAudioOutputFrame = nullptr;	///< aux output frame (array) for future use
 
 	uint32_t numAudioInChannels = 0;		///< audio input channel count
 	uint32_t numAudioOutChannels = 0;		///< audio input channel count
@@ -1165,11 +1199,13 @@ struct AudioProcDescriptor
 
 		sampleRate = data.sampleRate;
 		bitDepth = data.bitDepth;
+		processMode = data.processMode;
 		return *this;
 	}
 
     double sampleRate = 44100.0;	///< sample rate
     uint32_t bitDepth = 16;			///< wav file bit depth (not supported in all APIs)
+	hostProcessMode processMode = kRealtimeProcessMode;	///< real-time, prefetch or offline (from ResetInfo)
 };
 
 
@@ -1405,6 +1441,16 @@ public:
 	//     thread-safe mechanism that you design */
 	virtual void pushDataValue(double data) { }
 
+	/**    push a block of data values into the view in one call (audio thread)\n
+	//     Views that expect audio should override this with a lock-free block ring so that the\n
+	//     real-time thread does one copy per buffer instead of one enqueue per sample.\n
+	//     The default falls back to pushDataValue( ) for each value so older views keep working. */
+	virtual void pushDataBlock(const float* data, uint32_t numValues)
+	{
+		for (uint32_t i = 0; i < numValues; i++)
+			pushDataValue(data[i]);
+	}
+
 	/**    send a message into the view
 	//     The derived class should implement a lock-free ring buffer to store the message.\n
 	//     and handle all messaging in a thread-safe manner\n
@@ -1509,6 +1555,10 @@ public:
 	/**  parameter has changed, derived object handles this in a thread-safe manner */
 	virtual void parameterChanged(int32_t controlID, double actualValue, double normalizedValue) {}
 
+	/**  GUI timer: fill with the control IDs whose values changed since the last call; return false if the shell
+	     does not track changes (the GUI then refreshes every writeable control on each timer ping) */
+	virtual bool getGUIParameterChanges(std::vector<int32_t>& changedControlIDs) { return false; }
+
 	/**  get plugin parameter as normalize value */
 	virtual double getNormalizedPluginParameter(int32_t controlID) { return 0.0; }
 
@@ -1566,6 +1616,13 @@ public:
 
 	/** Fire off the next <IDI event */
 	virtual bool fireMidiEvents(uint32_t uSampleOffset) = 0;
+
+	/** Sub-block scheduling: sample offset of the next event that has not been fired yet; return false if there are
+	    no more events. Queues that do not override this are fired once per frame instead. */
+	virtual bool getNextEventOffset(uint32_t& sampleOffset) { return false; }
+
+	/** Sub-block scheduling: true if getNextEventOffset( ) is implemented */
+	virtual bool canScheduleEvents() { return false; }
 };
 
 
@@ -1593,6 +1650,316 @@ public:
 	/**    Get the sample-accurate value of the parameter at the next sample offset, determined by an internal counter
 	//     Returns true if dNextValue is different than the previous value */
 	virtual bool getNextValue(double& _nextValue) = 0;
+
+	/**    Sub-block scheduling: number of automation points in this buffer (0 = the queue cannot be scheduled) */
+	virtual uint32_t getPointCount() { return 0; }
+
+	/**    Sub-block scheduling: get one automation point; the value ramps linearly between points (normalized, no taper) */
+	virtual bool getPoint(uint32_t index, uint32_t& sampleOffset, double& normalizedValue) { return false; }
+};
+
+/**
+\enum processTimingStage
+\ingroup Constants-Enums
+\brief
+Stages of the buffer processing cycle that are timed by the ProcessTimer object.
+
+- kPreProcessStage, kFrameLoopStage, kPostProcessStage, kTotalProcessStage (entire processAudioBuffers call)
+*/
+enum processTimingStage { kPreProcessStage, kFrameLoopStage, kPostProcessStage, kTotalProcessStage, kNumProcessTimingStages };
+
+// --- load histogram: 1% bins, last bin catches everything >= 255%
+const uint32_t PROCESS_LOAD_HISTOGRAM_BINS = 256;
+
+// --- the rolling window: counts and sums are halved after this many buffers
+const uint32_t PROCESS_TIMING_HALF_LIFE = 4096;
+
+/**
+\struct ProcessTimingInfo
+\ingroup Structures
+\brief
+Snapshot of the buffer processing statistics collected by the ProcessTimer object.
+
+- times are in microseconds
+- load is the processAudioBuffers time as a percentage of the buffer deadline (numFrames / sampleRate)
+- mean and p99 values are rolling (exponentially forgotten); max values are held until resetProcessTiming()
+*/
+struct ProcessTimingInfo
+{
+	ProcessTimingInfo() {}
+
+	ProcessTimingInfo& operator=(const ProcessTimingInfo& data)	// need this override for collections to work
+	{
+		if (this == &data)
+			return *this;
+
+		blockCount = data.blockCount;
+		for (uint32_t i = 0; i < kNumProcessTimingStages; i++)
+		{
+			meanUsec[i] = data.meanUsec[i];
+			maxUsec[i] = data.maxUsec[i];
+		}
+		meanLoadPercent = data.meanLoadPercent;
+		p99LoadPercent = data.p99LoadPercent;
+		maxLoadPercent = data.maxLoadPercent;
+		return *this;
+	}
+
+	uint64_t blockCount = 0;							///< number of buffers timed since last reset
+	double meanUsec[kNumProcessTimingStages] = { 0 };	///< rolling mean time per stage
+	double maxUsec[kNumProcessTimingStages] = { 0 };	///< worst case time per stage
+	double meanLoadPercent = 0.0;						///< rolling mean of total time vs. buffer deadline
+	double p99LoadPercent = 0.0;						///< 99th percentile of total time vs. buffer deadline (1% resolution)
+	double maxLoadPercent = 0.0;						///< worst case total time vs. buffer deadline
+};
+
+/**
+\class ProcessTimer
+\ingroup ASPiK-Core
+\brief
+Lightweight, lock-free timing of the buffer processing cycle.
+
+Operation:
+- the audio thread calls beginBlock( ), then endStage( ) after each stage, then endBlock( )
+- uses std::chrono::steady_clock; four clock reads per buffer
+- the audio thread is the only writer; all storage is std::atomic so that any thread may call
+  getProcessTimingInfo( ) while audio is running
+- resetProcessTiming( ) only raises a flag; the audio thread clears the statistics at the top of the next buffer
+*/
+class ProcessTimer
+{
+public:
+	ProcessTimer() { clear(); }
+	~ProcessTimer() {}
+
+	/** turn timing on or off; when off the begin/end calls return immediately */
+	void setEnableTiming(bool enable) { enableTiming.store(enable, std::memory_order_relaxed); }
+
+	/** query the enable flag */
+	bool getEnableTiming() { return enableTiming.load(std::memory_order_relaxed); }
+
+	/** request a reset of the statistics from any thread */
+	void resetProcessTiming() { resetRequested.store(true, std::memory_order_relaxed); }
+
+	/**
+	\brief audio thread: start timing a new buffer
+
+	\param numFrames the buffer size
+	\param sampleRate the current sample rate, used to find the buffer deadline
+	*/
+	void beginBlock(uint32_t numFrames, double sampleRate)
+	{
+		timing = enableTiming.load(std::memory_order_relaxed);
+		if (!timing)
+			return;
+
+		if (resetRequested.exchange(false, std::memory_order_relaxed))
+			clear();
+
+		for (uint32_t i = 0; i < kNumProcessTimingStages; i++)
+			stageUsec[i] = 0.0;
+
+		deadlineUsec = sampleRate > 0.0 ? 1000000.0 * (double)numFrames / sampleRate : 0.0;
+		blockStart = std::chrono::steady_clock::now();
+		stageStart = blockStart;
+	}
+
+	/**
+	\brief audio thread: mark the end of a stage; the stage time is measured from the previous mark
+
+	\param stage the stage that just finished
+	*/
+	void endStage(processTimingStage stage)
+	{
+		if (!timing)
+			return;
+
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		stageUsec[stage] = std::chrono::duration<double, std::micro>(now - stageStart).count();
+		stageStart = now;
+	}
+
+	/** audio thread: finish the buffer and fold the stage times into the statistics; the total runs to the last endStage( ) mark */
+	void endBlock()
+	{
+		if (!timing)
+			return;
+
+		stageUsec[kTotalProcessStage] = std::chrono::duration<double, std::micro>(stageStart - blockStart).count();
+
+		// --- forget old history so the rolling values track the recent past
+		if (++windowCount >= PROCESS_TIMING_HALF_LIFE)
+		{
+			halveHistory();
+			windowCount = 0;
+		}
+
+		for (uint32_t i = 0; i < kNumProcessTimingStages; i++)
+		{
+			sumUsec[i].store(sumUsec[i].load(std::memory_order_relaxed) + stageUsec[i], std::memory_order_relaxed);
+			if (stageUsec[i] > maxUsec[i].load(std::memory_order_relaxed))
+				maxUsec[i].store(stageUsec[i], std::memory_order_relaxed);
+		}
+
+		double load = deadlineUsec > 0.0 ? 100.0 * stageUsec[kTotalProcessStage] / deadlineUsec : 0.0;
+		sumLoad.store(sumLoad.load(std::memory_order_relaxed) + load, std::memory_order_relaxed);
+		if (load > maxLoad.load(std::memory_order_relaxed))
+			maxLoad.store(load, std::memory_order_relaxed);
+
+		uint32_t bin = load >= (double)(PROCESS_LOAD_HISTOGRAM_BINS - 1) ? PROCESS_LOAD_HISTOGRAM_BINS - 1 : (uint32_t)load;
+		loadHistogram[bin].store(loadHistogram[bin].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+		windowBlocks.store(windowBlocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		blockCount.store(blockCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	/**
+	\brief any thread: copy out the current statistics; values may straddle one buffer update
+
+	\return the statistics in a ProcessTimingInfo structure
+	*/
+	ProcessTimingInfo getProcessTimingInfo()
+	{
+		ProcessTimingInfo info;
+		info.blockCount = blockCount.load(std::memory_order_acquire);
+
+		double blocks = (double)windowBlocks.load(std::memory_order_relaxed);
+		if (blocks <= 0.0)
+			return info;
+
+		for (uint32_t i = 0; i < kNumProcessTimingStages; i++)
+		{
+			info.meanUsec[i] = sumUsec[i].load(std::memory_order_relaxed) / blocks;
+			info.maxUsec[i] = maxUsec[i].load(std::memory_order_relaxed);
+		}
+		info.meanLoadPercent = sumLoad.load(std::memory_order_relaxed) / blocks;
+		info.maxLoadPercent = maxLoad.load(std::memory_order_relaxed);
+
+		// --- p99: walk down from the top bin until 1% of the counts are covered
+		uint32_t counts[PROCESS_LOAD_HISTOGRAM_BINS];
+		uint64_t total = 0;
+		for (uint32_t i = 0; i < PROCESS_LOAD_HISTOGRAM_BINS; i++)
+		{
+			counts[i] = loadHistogram[i].load(std::memory_order_relaxed);
+			total += counts[i];
+		}
+
+		uint64_t tail = 0;
+		uint64_t target = total / 100;
+		for (int32_t i = PROCESS_LOAD_HISTOGRAM_BINS - 1; i >= 0; i--)
+		{
+			tail += counts[i];
+			if (tail > target)
+			{
+				info.p99LoadPercent = (double)(i + 1);
+				break;
+			}
+		}
+		return info;
+	}
+
+protected:
+	/** audio thread only: zero everything */
+	void clear()
+	{
+		for (uint32_t i = 0; i < kNumProcessTimingStages; i++)
+		{
+			stageUsec[i] = 0.0;
+			sumUsec[i].store(0.0, std::memory_order_relaxed);
+			maxUsec[i].store(0.0, std::memory_order_relaxed);
+		}
+		for (uint32_t i = 0; i < PROCESS_LOAD_HISTOGRAM_BINS; i++)
+			loadHistogram[i].store(0, std::memory_order_relaxed);
+
+		sumLoad.store(0.0, std::memory_order_relaxed);
+		maxLoad.store(0.0, std::memory_order_relaxed);
+		windowBlocks.store(0, std::memory_order_relaxed);
+		blockCount.store(0, std::memory_order_relaxed);
+		windowCount = 0;
+	}
+
+	/** audio thread only: exponential forgetting of the rolling values (max values are held) */
+	void halveHistory()
+	{
+		for (uint32_t i = 0; i < kNumProcessTimingStages; i++)
+			sumUsec[i].store(0.5*sumUsec[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		for (uint32_t i = 0; i < PROCESS_LOAD_HISTOGRAM_BINS; i++)
+			loadHistogram[i].store(loadHistogram[i].load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+
+		sumLoad.store(0.5*sumLoad.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		windowBlocks.store(windowBlocks.load(std::memory_order_relaxed) / 2, std::memory_order_relaxed);
+	}
+
+	// --- shared with reader threads
+	std::atomic<bool> enableTiming{ true };							///< timing on/off
+	std::atomic<bool> resetRequested{ false };						///< reset flag, serviced by audio thread
+	std::atomic<double> sumUsec[kNumProcessTimingStages];			///< rolling sums of stage times
+	std::atomic<double> maxUsec[kNumProcessTimingStages];			///< worst case stage times
+	std::atomic<double> sumLoad{ 0.0 };								///< rolling sum of load percent
+	std::atomic<double> maxLoad{ 0.0 };								///< worst case load percent
+	std::atomic<uint32_t> loadHistogram[PROCESS_LOAD_HISTOGRAM_BINS];	///< load percent histogram, 1% bins
+	std::atomic<uint32_t> windowBlocks{ 0 };						///< rolling block count (halved with the sums)
+	std::atomic<uint64_t> blockCount{ 0 };							///< total blocks since reset
+
+	// --- audio thread only
+	bool timing = false;											///< enable flag latched for this buffer
+	uint32_t windowCount = 0;										///< blocks since last halving
+	double deadlineUsec = 0.0;										///< buffer deadline
+	double stageUsec[kNumProcessTimingStages];						///< stage times for this buffer
+	std::chrono::steady_clock::time_point blockStart;				///< start of buffer
+	std::chrono::steady_clock::time_point stageStart;				///< start of current stage
+};
+
+/**
+\class ScopedDenormalGuard
+\ingroup ASPiK-Core
+\brief
+RAII object that enables flush-to-zero (FTZ) and denormals-are-zero (DAZ) for the lifetime of the
+object, and restores the previous floating point control state on destruction.
+
+- place on the stack at the top of the audio processing function so that every DSP object
+  that runs inside that scope is protected from denormal slowdowns without per-sample checks
+- x86/x64: sets MXCSR bits 15 (FTZ) and 6 (DAZ)
+- ARM64: sets the FZ bit (24) of the FPCR
+- other targets: does nothing
+*/
+class ScopedDenormalGuard
+{
+public:
+	ScopedDenormalGuard()
+	{
+#if defined(HAVE_SSE_MXCSR)
+		previousState = _mm_getcsr();
+		_mm_setcsr(previousState | 0x8040); // --- FTZ (0x8000) | DAZ (0x0040)
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+		uint64_t fpcr = 0;
+		__asm__ __volatile__("mrs %0, fpcr" : "=r"(fpcr));
+		previousState = fpcr;
+		fpcr |= (1ULL << 24); // --- FZ
+		__asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+	}
+
+	~ScopedDenormalGuard()
+	{
+#if defined(HAVE_SSE_MXCSR)
+		_mm_setcsr(previousState);
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+		uint64_t fpcr = previousState;
+		__asm__ __volatile__("msr fpcr, %0" : : "r"(fpcr));
+#endif
+	}
+
+	// --- no copies; this object owns a piece of thread state
+	ScopedDenormalGuard(const ScopedDenormalGuard&) = delete;
+	ScopedDenormalGuard& operator=(const ScopedDenormalGuard&) = delete;
+
+private:
+#if defined(HAVE_SSE_MXCSR)
+	unsigned int previousState = 0;	///< MXCSR on entry
+#else
+	uint64_t previousState = 0;		///< FPCR on entry (ARM64)
+#endif
 };
 
 // --------------------------------------------------------------------------------------------------------------------------- //
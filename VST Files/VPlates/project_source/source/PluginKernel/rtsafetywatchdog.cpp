@@ -0,0 +1,192 @@
+// -----------------------------------------------------------------------------
+//   ASPiK Plugin Kernel File:  rtsafetywatchdog.cpp
+//
+/**
+    \file   rtsafetywatchdog.cpp
+    \brief  real-time safety watchdog implementation; interposes the heap and
+    		mutex functions for the whole module
+    		- test builds only: compiled to nothing unless ENABLE_RT_SAFETY_WATCHDOG is defined
+    		- operator new/delete everywhere; malloc/calloc/realloc/free on glibc;
+    		  pthread_mutex_lock on POSIX systems
+    		- interposition is complete for a statically linked offline harness; inside a
+    		  plugin bundle it only sees calls made from the bundle itself
+    		- http://www.aspikplugins.com
+    		- http://www.willpirkle.com
+*/
+// -----------------------------------------------------------------------------
+#ifdef ENABLE_RT_SAFETY_WATCHDOG
+
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE		// --- RTLD_NEXT
+#endif
+
+#include "rtsafetywatchdog.h"
+
+#include <atomic>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <execinfo.h>
+#endif
+
+// --- per-thread section depth; a report in progress suppresses the allocations made while reporting
+static thread_local int realTimeSectionDepth = 0;
+static thread_local bool reportingViolation = false;
+
+static std::atomic<uint32_t> realTimeSafetyViolations{ 0 };
+static std::atomic<bool> abortOnRealTimeSafetyViolation{ false };
+
+// --- the real heap; on glibc we replace malloc itself, so go around it
+#if defined(__GLIBC__)
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+extern "C" void __libc_free(void* ptr);
+static inline void* rawMalloc(size_t size) { return __libc_malloc(size); }
+static inline void rawFree(void* ptr) { __libc_free(ptr); }
+#else
+static inline void* rawMalloc(size_t size) { return malloc(size); }
+static inline void rawFree(void* ptr) { free(ptr); }
+#endif
+
+void enterRealTimeSection() { realTimeSectionDepth++; }
+void leaveRealTimeSection() { realTimeSectionDepth--; }
+uint32_t getRealTimeSafetyViolationCount() { return realTimeSafetyViolations.load(std::memory_order_relaxed); }
+void resetRealTimeSafetyViolationCount() { realTimeSafetyViolations.store(0, std::memory_order_relaxed); }
+void setRealTimeSafetyAbortOnViolation(bool abortOnViolation) { abortOnRealTimeSafetyViolation.store(abortOnViolation); }
+
+/**
+\brief report a forbidden call if this thread is inside a real-time section
+
+\param function name of the intercepted function
+\param size bytes requested, or 0
+*/
+static void checkRealTimeSafety(const char* function, size_t size)
+{
+	if (realTimeSectionDepth <= 0 || reportingViolation)
+		return;
+
+	reportingViolation = true;
+	uint32_t count = realTimeSafetyViolations.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	char message[160];
+	int length = snprintf(message, sizeof(message), "*** RT-SAFETY VIOLATION #%u: %s(%zu) on the audio thread\n", count, function, size);
+
+#ifndef _WIN32
+	// --- straight to the file descriptor: no stdio locks, no heap
+	if (length > 0)
+		write(STDERR_FILENO, message, (size_t)length < sizeof(message) ? (size_t)length : sizeof(message) - 1);
+
+	void* frames[48];
+	int numFrames = backtrace(frames, 48);
+	backtrace_symbols_fd(frames, numFrames, STDERR_FILENO);
+#else
+	if (length > 0)
+		fputs(message, stderr);
+#endif
+
+	if (abortOnRealTimeSafetyViolation.load())
+		abort();
+
+	reportingViolation = false;
+}
+
+// --- C++ heap
+void* operator new(size_t size)
+{
+	checkRealTimeSafety("operator new", size);
+	void* ptr = rawMalloc(size ? size : 1);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	checkRealTimeSafety("operator new[]", size);
+	void* ptr = rawMalloc(size ? size : 1);
+	if (!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	checkRealTimeSafety("operator new", size);
+	return rawMalloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	checkRealTimeSafety("operator new[]", size);
+	return rawMalloc(size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	if (ptr) checkRealTimeSafety("operator delete", 0);
+	rawFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	if (ptr) checkRealTimeSafety("operator delete[]", 0);
+	rawFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { operator delete[](ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { operator delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { operator delete[](ptr); }
+
+// --- C heap
+#if defined(__GLIBC__)
+extern "C" void* malloc(size_t size) noexcept
+{
+	checkRealTimeSafety("malloc", size);
+	return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) noexcept
+{
+	checkRealTimeSafety("calloc", count*size);
+	return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) noexcept
+{
+	checkRealTimeSafety("realloc", size);
+	return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void* ptr) noexcept
+{
+	if (ptr) checkRealTimeSafety("free", 0);
+	__libc_free(ptr);
+}
+#endif
+
+// --- locks
+#ifndef _WIN32
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+{
+	typedef int(*MutexLockFunction)(pthread_mutex_t*);
+	static std::atomic<MutexLockFunction> nextMutexLock{ nullptr };
+
+	checkRealTimeSafety("pthread_mutex_lock", 0);
+
+	MutexLockFunction mutexLock = nextMutexLock.load(std::memory_order_acquire);
+	if (!mutexLock)
+	{
+		mutexLock = (MutexLockFunction)dlsym(RTLD_NEXT, "pthread_mutex_lock");
+		nextMutexLock.store(mutexLock, std::memory_order_release);
+	}
+	return mutexLock(mutex);
+}
+#endif
+
+#endif // ENABLE_RT_SAFETY_WATCHDOG
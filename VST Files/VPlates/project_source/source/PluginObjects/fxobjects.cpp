@@ -54,12 +54,13 @@ double Biquad::getS_value()
 
 - RULES:\n
 1) do all math required to form the output y(n), reading registers as required - do NOT write registers \n
-2) check for underflow, which can happen with feedback structures\n
-3) lastly, update the states of the z^-1 registers in the state array just before returning\n
+2) lastly, update the states of the z^-1 registers in the state array just before returning\n
 
 - NOTES:\n
 the storageComponent or "S" value is used for Zavalishin's VA filters and is only
 available on two of the forms: direct and transposed canonical\n
+there is no per-sample underflow check; denormals are flushed by the ScopedDenormalGuard
+that wraps processAudioBuffers\n
 
 \param xn the input sample x(n)
 \returns the biquad processed output y(n)
@@ -75,10 +76,7 @@ double Biquad::processAudioSample(double xn)
 					coeffArray[b1] * stateArray[y_z1] -
 					coeffArray[b2] * stateArray[y_z2];
 
-		// --- 2) underflow check
-		checkFloatUnderflow(yn);
-
-		// --- 3) update states
+		// --- 2) update states
 		stateArray[x_z2] = stateArray[x_z1];
 		stateArray[x_z1] = xn;
 
@@ -98,10 +96,7 @@ double Biquad::processAudioSample(double xn)
 		// --- y(n):
 		double yn = coeffArray[a0] * wn + coeffArray[a1] * stateArray[x_z1] + coeffArray[a2] * stateArray[x_z2];
 
-		// --- 2) underflow check
-		checkFloatUnderflow(yn);
-
-		// --- 3) update states
+		// --- 2) update states
 		stateArray[x_z2] = stateArray[x_z1];
 		stateArray[x_z1] = wn;
 
@@ -118,10 +113,7 @@ double Biquad::processAudioSample(double xn)
 		// --- y(n) = a0*w(n) + stateArray[x_z1]
 		double yn = coeffArray[a0] * wn + stateArray[x_z1];
 
-		// --- 2) underflow check
-		checkFloatUnderflow(yn);
-
-		// --- 3) update states
+		// --- 2) update states
 		stateArray[y_z1] = stateArray[y_z2] - coeffArray[b1] * wn;
 		stateArray[y_z2] = -coeffArray[b2] * wn;
 
@@ -136,10 +128,7 @@ double Biquad::processAudioSample(double xn)
 		// --- 1)  form output y(n) = a0*x(n) + stateArray[x_z1]
 		double yn = coeffArray[a0] * xn + stateArray[x_z1];
 
-		// --- 2) underflow check
-		checkFloatUnderflow(yn);
-
-		// --- shuffle/update
+		// --- 2) shuffle/update
 		stateArray[x_z1] = coeffArray[a1]*xn - coeffArray[b1]*yn + stateArray[x_z2];
 		stateArray[x_z2] = coeffArray[a2]*xn - coeffArray[b2]*yn;
 
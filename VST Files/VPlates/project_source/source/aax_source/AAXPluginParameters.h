@@ -545,6 +545,13 @@ public:
             customViewIF->pushDataValue(data);
     }
 
+    /** forward call to ICustomView interface *if it is still alive* */
+    virtual void pushDataBlock(const float* data, uint32_t numValues)
+    {
+        if (customViewIF)
+            customViewIF->pushDataBlock(data, numValues);
+    }
+
     /** forward call to ICustomView interface *if it is still alive* */
     virtual void sendMessage(void* data)
     {
@@ -873,6 +880,18 @@ public:
         return midiBuffersize;
     }
 
+    /** sample offset of the next packet */
+    virtual bool getNextEventOffset(unsigned int& sampleOffset)
+    {
+        if(midiBuffersize == 0 || NULL == ioPacketPtr) return false;
+
+        sampleOffset = ioPacketPtr->mTimestamp;
+        return true;
+    }
+
+    /** packets arrive in timestamp order, so the core can schedule them */
+    virtual bool canScheduleEvents() { return true; }
+
     /** send MIDI event with this sample offset to the core for processing */
     virtual bool fireMidiEvents(unsigned int sampleOffset)
     {
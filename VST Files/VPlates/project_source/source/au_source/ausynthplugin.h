@@ -380,6 +380,13 @@ public:
             customViewIF->pushDataValue(data);
     }
 
+    /** forward call to ICustomView interface *if it is still alive* */
+    virtual void pushDataBlock(const float* data, uint32_t numValues)
+    {
+        if (customViewIF)
+            customViewIF->pushDataBlock(data, numValues);
+    }
+
     /** forward call to ICustomView interface *if it is still alive* */
     virtual void sendMessage(void* data)
     {
@@ -752,6 +759,19 @@ public:
             return midiEventQueueA.size();
     }
 
+    /** sample offset of the next event in the currently active reading queue */
+    virtual bool getNextEventOffset(unsigned int& sampleOffset)
+    {
+        std::queue<midiEvent>* readingQueue = writingQueueA ? &midiEventQueueB : &midiEventQueueA;
+        if(readingQueue->size() <= 0) return false;
+
+        sampleOffset = readingQueue->front().midiSampleOffset;
+        return true;
+    }
+
+    /** events are queued in render order, so the core can schedule them */
+    virtual bool canScheduleEvents() { return true; }
+
     /** send MIDI event with this sample offset to the core for processing */
     virtual bool fireMidiEvents(unsigned int sampleOffset)
     {
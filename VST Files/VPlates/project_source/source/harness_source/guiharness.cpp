@@ -0,0 +1,237 @@
+// -----------------------------------------------------------------------------
+//    ASPiK Plugin Harness File:  guiharness.cpp
+//
+/**
+    \file   guiharness.cpp
+    \brief  GUI benchmark for the PluginGUI object; needs VSTGUI, so it is only built with VST_SDK_BUILD
+    		- editor open: the first editor parses the XML and decodes the bitmaps, later editors get the
+    		  parsed description from UIDescriptionCache; both build the view tree
+    		- GUI timer: PluginGUI::idle( ) per ping, with the dirty list the VST3 shell provides and with the full
+    		  sweep of the shells that do not track changes
+    		- no window is opened, so the platform frame and the repaints are not part of the numbers
+    		- built with the CMake option PLUGIN_TEST_HARNESS; run it by hand, it is not a ctest
+    		- usage: guiharness [path to PluginGUI.uidesc]
+    		- http://www.aspikplugins.com
+    		- http://www.willpirkle.com
+*/
+// -----------------------------------------------------------------------------
+#include "plugingui.h"
+
+#include <chrono>
+#include <stdio.h>
+
+using namespace VSTGUI;
+
+// --- the GUI timer benchmark flags every tag below this one
+const int32_t kHarnessMaxControlTag = 32;
+
+/**
+\class HarnessGUIPluginConnector
+\ingroup ASPiK-GUI
+\brief
+Stands in for the plugin shell: hands PluginGUI::idle( ) a fixed list of changed parameters on every ping.
+
+Operation:
+- trackChanges false makes it behave like the AU, AAX and RAFX shells (no change list, full sweep)
+*/
+class HarnessGUIPluginConnector : public IGUIPluginConnector
+{
+public:
+	virtual bool registerCustomView(std::string customViewName, ICustomView* customViewConnector) { return false; }
+	virtual bool deRegisterCustomView(ICustomView* customViewConnector) { return false; }
+	virtual bool guiDidOpen() { return true; }
+	virtual bool guiWillClose() { return true; }
+	virtual bool guiTimerPing() { return true; }
+
+	virtual bool getGUIParameterChanges(std::vector<int32_t>& changedControlIDs)
+	{
+		changedControlIDs = changes;
+		return trackChanges;
+	}
+
+	virtual double getNormalizedPluginParameter(int32_t controlID)
+	{
+		// --- a new value on every read, so nothing is skipped as unchanged
+		value = value > 0.5 ? 0.25 : 0.75;
+		return value;
+	}
+
+	std::vector<int32_t> changes;	///< control IDs reported as changed on every ping
+	bool trackChanges = true;		///< false: report no change list, like the shells without change flags
+	double value = 0.25;			///< last value handed out
+};
+
+/**
+\class HarnessPluginGUI
+\ingroup ASPiK-GUI
+\brief
+A PluginGUI with no window: builds the "Editor" view tree the way createGUI( ) does, so its controls register
+their receivers and meters, and lets the harness call idle( ) directly.
+*/
+class HarnessPluginGUI : public PluginGUI
+{
+public:
+	HarnessPluginGUI(UTF8StringPtr xmlFile, IGUIPluginConnector* connector) : PluginGUI(xmlFile)
+	{
+		guiPluginConnector = connector;
+		editorView = description ? description->createView("Editor", this) : nullptr;
+	}
+	virtual ~HarnessPluginGUI()
+	{
+		deleteControlUpdateReceivers();
+		forgetWriteableControls();
+		if (editorView)
+			editorView->forget();
+	}
+
+	/** true if the view tree was built */
+	bool isValid() { return editorView != nullptr; }
+
+private:
+	CView* editorView = nullptr;
+};
+
+/**
+\brief time a number of editor opens, each one getting the description and building the "Editor" view tree
+
+\param xmlFile the GUI description file
+\param numOpens number of editors to open (one after the other)
+\param description_mSec returns the mean time to get the description, in mSec
+\param viewTree_mSec returns the mean time to build the view tree, in mSec
+
+\return false if the description could not be parsed or has no "Editor" template
+*/
+static bool timeEditorOpens(UTF8StringPtr xmlFile, uint32_t numOpens, double& description_mSec, double& viewTree_mSec)
+{
+	description_mSec = 0.0;
+	viewTree_mSec = 0.0;
+
+	for (uint32_t n = 0; n < numOpens; n++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		UIDescription* description = UIDescriptionCache::getDescription(xmlFile);
+		auto parsed = std::chrono::steady_clock::now();
+		if (!description)
+			return false;
+
+		CView* view = description->createView("Editor", nullptr);
+		auto built = std::chrono::steady_clock::now();
+
+		description_mSec += std::chrono::duration<double, std::milli>(parsed - start).count();
+		viewTree_mSec += std::chrono::duration<double, std::milli>(built - parsed).count();
+
+		// --- close the editor, as PluginGUI::~PluginGUI( ) does
+		if (view)
+			view->forget();
+		UIDescriptionCache::releaseDescription(description);
+		description->forget();
+
+		if (!view)
+			return false;
+	}
+
+	description_mSec /= (double)numOpens;
+	viewTree_mSec /= (double)numOpens;
+	return true;
+}
+
+/**
+\brief editor open cost with and without the UIDescriptionCache
+
+Operation:
+- first opens: keep-alive off, so each editor closes before the next opens and every open parses the XML
+- later opens: keep-alive on (VST3: between InitModule and DeinitModule), primed with one open, so every open
+  shares the parsed description and the bitmaps it has already decoded
+
+\param xmlFile the GUI description file
+
+\return false if the description could not be used
+*/
+static bool runEditorOpenBenchmark(UTF8StringPtr xmlFile)
+{
+	const uint32_t numOpens = 20;
+	double firstDescription_mSec = 0.0;
+	double firstViewTree_mSec = 0.0;
+	double cachedDescription_mSec = 0.0;
+	double cachedViewTree_mSec = 0.0;
+
+	UIDescriptionCache::setKeepAlive(false);
+	bool parsed = timeEditorOpens(xmlFile, numOpens, firstDescription_mSec, firstViewTree_mSec);
+
+	UIDescriptionCache::setKeepAlive(true);
+	double primeDescription_mSec = 0.0;
+	double primeViewTree_mSec = 0.0;
+	parsed = parsed && timeEditorOpens(xmlFile, 1, primeDescription_mSec, primeViewTree_mSec);
+	parsed = parsed && timeEditorOpens(xmlFile, numOpens, cachedDescription_mSec, cachedViewTree_mSec);
+	UIDescriptionCache::setKeepAlive(false);
+
+	if (!parsed)
+	{
+		printf("cannot parse %s or it has no Editor template\n", xmlFile);
+		return false;
+	}
+
+	double first_mSec = firstDescription_mSec + firstViewTree_mSec;
+	double cached_mSec = cachedDescription_mSec + cachedViewTree_mSec;
+	printf("\neditor open (no window, %u opens)   description ms   view tree ms   total ms   x first open\n", numOpens);
+	printf("%-34s   %14.3f   %12.3f   %8.3f   %12.2f\n", "first open (parse)", firstDescription_mSec, firstViewTree_mSec, first_mSec, 1.0);
+	printf("%-34s   %14.3f   %12.3f   %8.3f   %12.2f\n", "later opens (UIDescriptionCache)", cachedDescription_mSec, cachedViewTree_mSec, cached_mSec,
+		first_mSec > 0.0 ? cached_mSec / first_mSec : 0.0);
+	return true;
+}
+
+/**
+\brief time PluginGUI::idle( ) with and without a change list
+
+\param xmlFile the GUI description file
+
+\return false if the description could not be used
+*/
+static bool runGUITimerBenchmark(UTF8StringPtr xmlFile)
+{
+	const uint32_t numPings = 20000;
+	const char* caseNames[] = { "dirty list, nothing changed", "dirty list, one parameter changed",
+		"dirty list, every parameter changed", "meter sweep (no change tracking)" };
+
+	HarnessGUIPluginConnector connector;
+	HarnessPluginGUI* pluginGUI = new HarnessPluginGUI(xmlFile, &connector);
+	if (!pluginGUI->isValid())
+	{
+		printf("cannot parse %s or it has no Editor template\n", xmlFile);
+		pluginGUI->forget();
+		return false;
+	}
+
+	printf("\nGUI timer (no window, %u pings)          us/ping\n", numPings);
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		connector.changes.clear();
+		if (i == 1)
+			connector.changes.push_back(0);
+		else if (i == 2)
+		{
+			for (int32_t tag = 0; tag < kHarnessMaxControlTag; tag++)
+				connector.changes.push_back(tag);
+		}
+		connector.trackChanges = i < 3;
+
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t n = 0; n < numPings; n++)
+			pluginGUI->idle();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		printf("%-38s   %9.3f\n", caseNames[i], 1.0e6*seconds / (double)numPings);
+	}
+
+	pluginGUI->forget();
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	UTF8StringPtr xmlFile = argc < 2 ? "PluginGUI.uidesc" : argv[1];
+
+	bool ok = runEditorOpenBenchmark(xmlFile);
+	ok = ok && runGUITimerBenchmark(xmlFile);
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,664 @@
+// -----------------------------------------------------------------------------
+//    ASPiK Plugin Harness File:  pluginharness.cpp
+//
+/**
+    \file   pluginharness.cpp
+    \brief  offline test harness for the PluginCore object; needs no plugin SDK
+    		- real-time safety: no heap allocation or mutex lock after initialize( ), in reset( )
+    		  or in processAudioBuffers( ) (see rtsafetywatchdog.h)
+    		- delay line storage benchmark: throughput and cache misses for each bufferStorage format
+    		- reverb tail benchmark: CPU per buffer from noise down through the denormal range, and asleep
+    		- process mode benchmark: CPU and output difference of the offline engine against the real-time one
+    		- GUI timer benchmark (kernel side): change flags against a sweep of every parameter; guiharness.cpp times
+    		  PluginGUI::idle( ) itself
+    		- built with the CMake option PLUGIN_TEST_HARNESS; ctest runs the real-time safety check
+    		- usage: harness [--rt-safety | --benchmark]; no argument runs both
+    		- http://www.aspikplugins.com
+    		- http://www.willpirkle.com
+*/
+// -----------------------------------------------------------------------------
+#include "plugincore.h"
+
+#ifndef ENABLE_RT_SAFETY_WATCHDOG
+#error the harness needs ENABLE_RT_SAFETY_WATCHDOG (see harness_cmake/CMakeLists.txt)
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// --- largest buffer and channel count the real-time safety check runs
+const uint32_t kHarnessMaxFrames = 512;
+const uint32_t kHarnessMaxChannels = 8;
+
+/**
+\class HarnessMidiEventQueue
+\ingroup ASPiK-Core
+\brief
+An empty MIDI queue for offline processing; the plate has no MIDI input.
+*/
+class HarnessMidiEventQueue : public IMidiEventQueue
+{
+public:
+	virtual uint32_t getEventCount() { return 0; }
+	virtual bool fireMidiEvents(uint32_t) { return true; }
+};
+
+/**
+\class CacheMissCounter
+\ingroup ASPiK-Core
+\brief
+Counts the last level cache misses of this thread with the Linux perf interface.
+
+Operation:
+- isValid( ) is false where the counter is not available (other platforms, or perf_event_paranoid forbids it);
+  the benchmark then reports throughput only
+*/
+class CacheMissCounter
+{
+public:
+	CacheMissCounter()
+	{
+#ifdef __linux__
+		perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+	}
+	~CacheMissCounter()
+	{
+#ifdef __linux__
+		if (fd >= 0)
+			close(fd);
+#endif
+	}
+
+	/** true if the counter works on this system */
+	bool isValid() { return fd >= 0; }
+
+	/** zero the count and start counting */
+	void start()
+	{
+#ifdef __linux__
+		if (fd < 0)
+			return;
+		ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+	}
+
+	/** stop counting
+	\return the cache misses since start( )
+	*/
+	uint64_t stop()
+	{
+		uint64_t count = 0;
+#ifdef __linux__
+		if (fd < 0)
+			return 0;
+		ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(fd, &count, sizeof(count)) != sizeof(count))
+			count = 0;
+#endif
+		return count;
+	}
+
+private:
+	int fd = -1;
+
+	CacheMissCounter(const CacheMissCounter&) = delete;
+	CacheMissCounter& operator=(const CacheMissCounter&) = delete;
+};
+
+/**
+\brief fill a buffer with white noise from a linear congruential generator (no heap, no locks)
+
+\param buffer the buffer to fill
+\param length number of samples
+\param seed generator state, updated
+\param amplitude peak amplitude
+*/
+static void fillNoise(float* buffer, uint32_t length, uint32_t& seed, float amplitude)
+{
+	for (uint32_t i = 0; i < length; i++)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		buffer[i] = amplitude*((float)(seed >> 8) / 8388608.0f - 1.0f);
+	}
+}
+
+/**
+\brief run a number of buffers of noise (or silence) through the plugin
+
+\param pluginCore the plugin
+\param info buffer information, set up by the caller
+\param numBuffers number of buffers to process
+\param amplitude noise amplitude, 0 for silence
+\param seed noise generator state, updated
+
+\return the number of output samples that were NaN or infinite
+*/
+static uint32_t processNoise(PluginCore& pluginCore, ProcessBufferInfo& info, uint32_t numBuffers, float amplitude, uint32_t& seed)
+{
+	uint32_t badSamples = 0;
+	for (uint32_t n = 0; n < numBuffers; n++)
+	{
+		for (uint32_t i = 0; i < info.numAudioInChannels; i++)
+			fillNoise(info.inputs[i], info.numFramesToProcess, seed, amplitude);
+		pluginCore.processAudioBuffers(info);
+
+		for (uint32_t i = 0; i < info.numAudioOutChannels; i++)
+		{
+			for (uint32_t j = 0; j < info.numFramesToProcess; j++)
+				badSamples += std::isfinite(info.outputs[i][j]) ? 0 : 1;
+		}
+	}
+	return badSamples;
+}
+
+/**
+\brief check that nothing allocates or locks once the plugin is initialized
+
+Operation:
+- initialize( ) is the only place allowed to allocate; from then on every reset( ), parameter change and
+  processAudioBuffers( ) call runs inside a ScopedRealTimeSection
+- each prepared sample rate is run in real-time and offline mode, with every channel format the plate supports,
+  switching the engine, the tank rate (Low Pass) and the Cross-Feed mid-tail
+- then the tank is left to fall asleep (silence detection, staggered flush, the slower tank rate held back until
+  then) and woken up again
+
+\return true if the watchdog saw no violations, the output stayed finite and the tank fell asleep
+*/
+static bool checkRealTimeSafety()
+{
+	// --- everything the audio thread touches is set up before the watchdog is armed
+	static float audioBuffers[2][kHarnessMaxChannels][kHarnessMaxFrames];
+	float* inputs[kHarnessMaxChannels];
+	float* outputs[kHarnessMaxChannels];
+	for (uint32_t i = 0; i < kHarnessMaxChannels; i++)
+	{
+		inputs[i] = audioBuffers[0][i];
+		outputs[i] = audioBuffers[1][i];
+	}
+
+	HarnessMidiEventQueue midiEventQueue;
+	HostInfo hostInfo;
+	ParameterUpdateInfo paramInfo;
+
+	PluginCore pluginCore;
+	PluginInfo pluginInfo;
+	pluginCore.initialize(pluginInfo);
+
+	ProcessBufferInfo info;
+	info.inputs = inputs;
+	info.outputs = outputs;
+	info.numFramesToProcess = kHarnessMaxFrames;
+	info.hostInfo = &hostInfo;
+	info.midiEventQueue = &midiEventQueue;
+
+	const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, kMaxPreparedSampleRate };
+	const hostProcessMode processModes[] = { kRealtimeProcessMode, kOfflineProcessMode };
+	const uint32_t channelFormats[][3] = {	// --- input format, output format, channel count
+		{ kCFMono, kCFStereo, 2 },
+		{ kCFStereo, kCFStereo, 2 },
+		{ kCF5p1, kCF5p1, 6 },
+		{ kCF7p1DTS, kCF7p1DTS, 8 } };
+
+	resetRealTimeSafetyViolationCount();
+	uint32_t seed = 1;
+	uint32_t badSamples = 0;
+	for (double sampleRate : sampleRates)
+	{
+		for (hostProcessMode processMode : processModes)
+		{
+			for (const uint32_t* format : channelFormats)
+			{
+				info.numAudioInChannels = format[0] == kCFMono ? 1 : format[2];
+				info.numAudioOutChannels = format[2];
+				info.channelIOConfig.inputChannelFormat = format[0];
+				info.channelIOConfig.outputChannelFormat = format[1];
+
+				ScopedRealTimeSection realTimeSection;
+				ResetInfo resetInfo(sampleRate, 32);
+				resetInfo.processMode = processMode;
+				pluginCore.reset(resetInfo);
+
+				badSamples += processNoise(pluginCore, info, 50, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::lowpass_freq, 20000.0, paramInfo);
+				badSamples += processNoise(pluginCore, info, 50, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::engine, 4.0, paramInfo);	// --- True Stereo
+				badSamples += processNoise(pluginCore, info, 20, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::cross_feed, 50.0, paramInfo);
+				badSamples += processNoise(pluginCore, info, 30, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::engine, 1.0, paramInfo);	// --- FDN 8
+				badSamples += processNoise(pluginCore, info, 50, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::lowpass_freq, 5000.0, paramInfo);
+				badSamples += processNoise(pluginCore, info, 50, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::engine, 0.0, paramInfo);	// --- Plate
+				badSamples += processNoise(pluginCore, info, 50, 0.25f, seed);
+				pluginCore.updatePluginParameter(controlID::cross_feed, 0.0, paramInfo);
+			}
+		}
+	}
+
+	// --- sleep and wake up; the tail needs a few seconds to get below kTankSilenceThreshold
+	info.numAudioInChannels = info.numAudioOutChannels = 2;
+	info.channelIOConfig.inputChannelFormat = info.channelIOConfig.outputChannelFormat = kCFStereo;
+	bool fellAsleep = false;
+	{
+		ScopedRealTimeSection realTimeSection;
+		ResetInfo resetInfo(96000.0, 32);
+		pluginCore.reset(resetInfo);
+		pluginCore.updatePluginParameter(controlID::lowpass_freq, 20000.0, paramInfo);
+		badSamples += processNoise(pluginCore, info, 100, 0.25f, seed);
+		pluginCore.updatePluginParameter(controlID::lowpass_freq, 5000.0, paramInfo);
+		for (uint32_t n = 0; n < 2000 && !fellAsleep; n++)
+		{
+			badSamples += processNoise(pluginCore, info, 1, 0.0f, seed);
+			fellAsleep = pluginCore.tankAsleep;
+		}
+		badSamples += processNoise(pluginCore, info, 10, 0.25f, seed);
+	}
+
+	uint32_t violations = getRealTimeSafetyViolationCount();
+	printf("real-time safety: %u heap/lock calls after initialize( ), %u NaN/inf output samples%s\n", violations, badSamples,
+		fellAsleep ? "" : "; the tank never fell asleep");
+	return violations == 0 && badSamples == 0 && fellAsleep;
+}
+
+/**
+\brief process a number of buffers of noise (or silence) and time them
+
+\param pluginCore the plugin
+\param info buffer information, set up by the caller
+\param numBuffers number of buffers to process
+\param amplitude noise amplitude, 0 for silence
+\param seed noise generator state, updated
+
+\return microseconds per buffer
+*/
+static double timeBuffers(PluginCore& pluginCore, ProcessBufferInfo& info, uint32_t numBuffers, float amplitude, uint32_t& seed)
+{
+	auto start = std::chrono::steady_clock::now();
+	processNoise(pluginCore, info, numBuffers, amplitude, seed);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return 1.0e6*seconds / (double)numBuffers;
+}
+
+/**
+\brief CPU cost of the reverb tail, from noise down through the range where the float tank lines would go subnormal
+
+Operation:
+- stereo at 48kHz with the default preset; the tank is held awake (samplesToSleep) so the whole tail runs
+  through the frame loop, then it is allowed to sleep
+- run with and without enableAntiDenormal: with it the tail settles on the kAntiDenormalOffset floor (-360dB),
+  without it the tail keeps falling until FTZ/DAZ (ScopedDenormalGuard) flushes it to zero
+- tail buffers are grouped by output peak; below -600dB the float tank lines are near FLT_MIN, where a
+  missing ScopedDenormalGuard shows up as a tail that costs several times as much as the noise
+- the last row is the asleep path (silence in, silence out)
+*/
+static void runTailBenchmark()
+{
+	static float audioBuffers[2][2][kHarnessMaxFrames];
+	float* inputs[2] = { audioBuffers[0][0], audioBuffers[0][1] };
+	float* outputs[2] = { audioBuffers[1][0], audioBuffers[1][1] };
+
+	HarnessMidiEventQueue midiEventQueue;
+	HostInfo hostInfo;
+
+	ProcessBufferInfo info;
+	info.inputs = inputs;
+	info.outputs = outputs;
+	info.numAudioInChannels = info.numAudioOutChannels = 2;
+	info.channelIOConfig.inputChannelFormat = info.channelIOConfig.outputChannelFormat = kCFStereo;
+	info.numFramesToProcess = kHarnessMaxFrames;
+	info.hostInfo = &hostInfo;
+	info.midiEventQueue = &midiEventQueue;
+
+	const double bandFloors_dB[] = { -120.0, -600.0, -1.0e9 };
+	const char* bandNames[] = { "tail above -120dB", "tail -120dB to -600dB", "tail below -600dB" };
+	const uint32_t timedBuffers = 2000;
+	const uint32_t maxTailBuffers = (uint32_t)(60.0*48000.0 / kHarnessMaxFrames);
+
+	printf("\nreverb tail (48kHz stereo, %u frames)   buffers   us/buffer   x noise\n", kHarnessMaxFrames);
+	const bool antiDenormalSettings[] = { true, false };
+	for (bool antiDenormal : antiDenormalSettings)
+	{
+		PluginCore pluginCore;
+		PluginInfo pluginInfo;
+		pluginCore.initialize(pluginInfo);
+		ResetInfo resetInfo(48000.0, 32);
+		pluginCore.reset(resetInfo);
+		pluginCore.enableAntiDenormal = antiDenormal;
+
+		// --- hold the tank awake for the tail
+		uint32_t samplesToSleep = pluginCore.samplesToSleep;
+		pluginCore.samplesToSleep = 0xFFFFFFFF;
+
+		uint32_t seed = 1;
+		processNoise(pluginCore, info, 200, 0.25f, seed);
+		double noise_uSec = timeBuffers(pluginCore, info, timedBuffers, 0.25f, seed);
+
+		// --- tail: time each buffer, grouped by output peak; up to 60 seconds or until the output is exactly zero
+		double band_uSec[3] = { 0.0, 0.0, 0.0 };
+		uint32_t bandBuffers[3] = { 0, 0, 0 };
+		for (uint32_t n = 0; n < maxTailBuffers; n++)
+		{
+			auto start = std::chrono::steady_clock::now();
+			processNoise(pluginCore, info, 1, 0.0f, seed);
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			float peak = 0.f;
+			for (uint32_t i = 0; i < 2; i++)
+			{
+				for (uint32_t j = 0; j < kHarnessMaxFrames; j++)
+					peak = fmaxf(peak, fabsf(outputs[i][j]));
+			}
+			if (peak == 0.f)
+				break;
+
+			double peak_dB = 20.0*log10(peak);
+			uint32_t band = 0;
+			while (peak_dB < bandFloors_dB[band])
+				band++;
+			band_uSec[band] += 1.0e6*seconds;
+			bandBuffers[band]++;
+		}
+
+		// --- let it sleep
+		pluginCore.samplesToSleep = samplesToSleep;
+		for (uint32_t n = 0; n < 2000 && !pluginCore.tankAsleep; n++)
+			processNoise(pluginCore, info, 1, 0.0f, seed);
+		double asleep_uSec = timeBuffers(pluginCore, info, timedBuffers, 0.0f, seed);
+
+		printf("anti-denormal offset %s\n", antiDenormal ? "on" : "off");
+		printf("  %-36s  %7u   %9.2f   %7.2f\n", "noise", timedBuffers, noise_uSec, 1.0);
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (bandBuffers[i] == 0)
+				printf("  %-36s  %7u   %9s   %7s\n", bandNames[i], 0, "-", "-");
+			else
+			{
+				double uSec = band_uSec[i] / (double)bandBuffers[i];
+				printf("  %-36s  %7u   %9.2f   %7.2f\n", bandNames[i], bandBuffers[i], uSec, uSec / noise_uSec);
+			}
+		}
+		printf("  %-36s  %7u   %9.2f   %7.2f%s\n", "asleep", timedBuffers, asleep_uSec, asleep_uSec / noise_uSec,
+			pluginCore.tankAsleep ? "" : " (the tank never fell asleep)");
+	}
+}
+
+/**
+\brief render a noise burst and its tail in one process mode
+
+\param sampleRate the sample rate
+\param processMode real-time or offline (see hostProcessMode)
+\param render returns the left output
+
+\return microseconds per buffer
+*/
+static double renderProcessMode(double sampleRate, hostProcessMode processMode, std::vector<float>& render)
+{
+	static float audioBuffers[2][2][kHarnessMaxFrames];
+	float* inputs[2] = { audioBuffers[0][0], audioBuffers[0][1] };
+	float* outputs[2] = { audioBuffers[1][0], audioBuffers[1][1] };
+
+	HarnessMidiEventQueue midiEventQueue;
+	HostInfo hostInfo;
+
+	ProcessBufferInfo info;
+	info.inputs = inputs;
+	info.outputs = outputs;
+	info.numAudioInChannels = info.numAudioOutChannels = 2;
+	info.channelIOConfig.inputChannelFormat = info.channelIOConfig.outputChannelFormat = kCFStereo;
+	info.numFramesToProcess = kHarnessMaxFrames;
+	info.hostInfo = &hostInfo;
+	info.midiEventQueue = &midiEventQueue;
+
+	PluginCore pluginCore;
+	PluginInfo pluginInfo;
+	pluginCore.initialize(pluginInfo);
+	ResetInfo resetInfo(sampleRate, 32);
+	resetInfo.processMode = processMode;
+	pluginCore.reset(resetInfo);
+
+	// --- half a second of noise, then three seconds of tail
+	uint32_t noiseBuffers = (uint32_t)(0.5*sampleRate / kHarnessMaxFrames);
+	uint32_t tailBuffers = (uint32_t)(3.0*sampleRate / kHarnessMaxFrames);
+	render.clear();
+	render.reserve((noiseBuffers + tailBuffers)*kHarnessMaxFrames);
+
+	uint32_t seed = 1;
+	double seconds = 0.0;
+	for (uint32_t n = 0; n < noiseBuffers + tailBuffers; n++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		processNoise(pluginCore, info, 1, n < noiseBuffers ? 0.25f : 0.0f, seed);
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		render.insert(render.end(), outputs[0], outputs[0] + kHarnessMaxFrames);
+	}
+	return 1.0e6*seconds / (double)(noiseBuffers + tailBuffers);
+}
+
+/**
+\brief CPU and output difference of the offline (high quality) engine against the real-time engine
+
+Operation:
+- the same noise burst and tail rendered in kRealtimeProcessMode and kOfflineProcessMode; the offline engine
+  runs the tank oversampled with Lagrange reads, the real-time one at the host rate (or a reduced rate at high rates)
+- level is the offline render's energy relative to the realtime render; difference is the energy of
+  (offline - realtime) relative to the realtime render; the modulated reads take different paths, so the two
+  renders decorrelate and do not null even when the levels match
+*/
+static void runProcessModeBenchmark()
+{
+	const double sampleRates[] = { 48000.0, 96000.0 };
+
+	printf("\nprocess mode (stereo, %u frames)   realtime us/buffer   offline us/buffer   x realtime   level   difference\n", kHarnessMaxFrames);
+	for (double sampleRate : sampleRates)
+	{
+		std::vector<float> realtime;
+		std::vector<float> offline;
+		double realtime_uSec = renderProcessMode(sampleRate, kRealtimeProcessMode, realtime);
+		double offline_uSec = renderProcessMode(sampleRate, kOfflineProcessMode, offline);
+
+		double realtimeEnergy = 0.0;
+		double offlineEnergy = 0.0;
+		double difference = 0.0;
+		for (size_t i = 0; i < realtime.size(); i++)
+		{
+			realtimeEnergy += (double)realtime[i] * realtime[i];
+			offlineEnergy += (double)offline[i] * offline[i];
+			difference += ((double)offline[i] - realtime[i]) * ((double)offline[i] - realtime[i]);
+		}
+		double level_dB = realtimeEnergy > 0.0 && offlineEnergy > 0.0 ? 10.0*log10(offlineEnergy / realtimeEnergy) : 0.0;
+		double difference_dB = realtimeEnergy > 0.0 && difference > 0.0 ? 10.0*log10(difference / realtimeEnergy) : -999.0;
+
+		printf("%-6.0f Hz                          %18.2f   %17.2f   %10.2f   %+5.1f dB   %7.1f dB\n", sampleRate, realtime_uSec, offline_uSec,
+			offline_uSec / realtime_uSec, level_dB, difference_dB);
+	}
+}
+
+/**
+\brief kernel side of the GUI timer: collecting the changed parameters from the change flags against reading every
+parameter on every ping (PluginGUI::idle( ) itself needs VSTGUI, see guiharness.cpp)
+
+Operation:
+- each ping flags the changed parameters (markGUIParameterChanged( ), as the shell or the audio thread does), then
+  does what the timer does with them: getGUIParameterChanges( ) and one normalized read per changed parameter
+- the sweep reads every parameter on every ping, whether it changed or not
+*/
+static void runGUITimerBenchmark()
+{
+	const uint32_t numPings = 1000000;
+	const char* caseNames[] = { "change flags, nothing changed", "change flags, one parameter changed",
+		"change flags, every parameter changed", "sweep of every parameter" };
+
+	PluginCore pluginCore;
+	PluginInfo pluginInfo;
+	pluginCore.initialize(pluginInfo);
+
+	uint32_t numParameters = (uint32_t)pluginCore.getPluginParameterCount();
+	std::vector<int32_t> changedControlIDs;
+	changedControlIDs.reserve(numParameters);
+
+	printf("\nGUI timer, kernel side (%u parameters)      ns/ping\n", numParameters);
+	double sum = 0.0;
+	for (uint32_t i = 0; i < 4; i++)
+	{
+		uint32_t numChanges = i == 0 ? 0 : (i == 1 ? 1 : numParameters);
+		auto start = std::chrono::steady_clock::now();
+		for (uint32_t n = 0; n < numPings; n++)
+		{
+			if (i == 3)
+			{
+				for (uint32_t j = 0; j < numParameters; j++)
+					sum += pluginCore.getPluginParameterByIndex(j)->getControlValueNormalized();
+				continue;
+			}
+
+			for (uint32_t j = 0; j < numChanges; j++)
+				pluginCore.markGUIParameterChanged(pluginCore.getPluginParameterByIndex(j)->getControlID());
+
+			pluginCore.getGUIParameterChanges(changedControlIDs);
+			for (std::vector<int32_t>::iterator it = changedControlIDs.begin(); it != changedControlIDs.end(); ++it)
+				sum += pluginCore.getPluginParameterByControlID(*it)->getControlValueNormalized();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("%-40s   %9.1f\n", caseNames[i], 1.0e9*seconds / (double)numPings);
+	}
+
+	// --- keep the result alive
+	if (sum == 12345.678)
+		printf(" ");
+}
+
+/**
+\brief time a bank of delay lines in one storage format
+
+Operation:
+- numLines SimpleDelay objects of lineLength samples in series, each read with interpolation near its end, like
+  the tank lines; the working set is numLines*lineLength*(bytes per sample)
+
+\param storage the sample storage format
+\param numLines number of delay lines
+\param lineLength line length in samples (a power of two)
+\param cacheMisses returns the cache misses per 1000 line samples, or -1 if they cannot be counted
+
+\return nanoseconds per line sample
+*/
+static double benchmarkDelayStorage(bufferStorage storage, uint32_t numLines, uint32_t lineLength, double& cacheMisses)
+{
+	const double sampleRate = 1000.0;	// --- 1 sample per mSec, so delay times are in samples
+	const uint32_t blockLength = 256;
+	const uint64_t lineSamples = 1 << 25;
+
+	std::vector<SimpleDelay> lines(numLines);
+	for (uint32_t i = 0; i < numLines; i++)
+	{
+		lines[i].setStorageType(storage);
+		lines[i].createDelayBuffer(sampleRate, lineLength - 1);
+		SimpleDelayParameters params = lines[i].getParameters();
+		params.delayTime_mSec = lineLength - 2 - 0.37*(i % 7);
+		params.interpolate = true;
+		lines[i].setParameters(params);
+	}
+
+	float noise[blockLength];
+	uint32_t seed = 1;
+	fillNoise(noise, blockLength, seed, 0.25f);
+
+	// --- one pass through every line first, so every run starts with the same (cold) state
+	double sum = 0.0;
+	for (uint32_t n = 0; n < lineLength; n++)
+	{
+		double xn = noise[n % blockLength];
+		for (uint32_t i = 0; i < numLines; i++)
+			xn = 0.5*xn + 0.5*lines[i].processAudioSample(xn);
+		sum += xn;
+	}
+
+	CacheMissCounter cacheMissCounter;
+	uint64_t frames = lineSamples / numLines;
+	auto start = std::chrono::steady_clock::now();
+	cacheMissCounter.start();
+	for (uint64_t n = 0; n < frames; n++)
+	{
+		double xn = noise[n % blockLength];
+		for (uint32_t i = 0; i < numLines; i++)
+			xn = 0.5*xn + 0.5*lines[i].processAudioSample(xn);
+		sum += xn;
+	}
+	uint64_t misses = cacheMissCounter.stop();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// --- keep the result alive
+	if (sum == 12345.678)
+		printf(" ");
+
+	cacheMisses = cacheMissCounter.isValid() ? 1000.0*(double)misses / (double)(frames*numLines) : -1.0;
+	return 1.0e9*seconds / (double)(frames*numLines);
+}
+
+/**
+\brief throughput and cache misses of each bufferStorage format, for a bank of lines that fits in the cache and
+for one the size of many plate tanks at 192kHz
+*/
+static void runStorageBenchmark()
+{
+	const bufferStorage storageTypes[] = { bufferStorage::kNative, bufferStorage::kFloat, bufferStorage::kHalf, bufferStorage::kInt16 };
+	const char* storageNames[] = { "double", "float", "half", "int16" };
+	const uint32_t bankSizes[][2] = {	// --- lines, samples per line
+		{ 8, 4096 },
+		{ 64, 65536 } };
+
+	printf("\ndelay line storage      lines x length   working set   ns/line-sample   cache misses/1k line-samples\n");
+	for (const uint32_t* bank : bankSizes)
+	{
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			CircularBuffer<double> probe;
+			probe.setStorageType(storageTypes[i]);
+			double workingSet_kB = (double)bank[0] * bank[1] * probe.getStorageBytesPerSample() / 1024.0;
+
+			double cacheMisses = 0.0;
+			double ns = benchmarkDelayStorage(storageTypes[i], bank[0], bank[1], cacheMisses);
+			if (cacheMisses < 0.0)
+				printf("%-22s  %3u x %-8u   %8.0f kB   %14.2f   n/a\n", storageNames[i], bank[0], bank[1], workingSet_kB, ns);
+			else
+				printf("%-22s  %3u x %-8u   %8.0f kB   %14.2f   %.2f\n", storageNames[i], bank[0], bank[1], workingSet_kB, ns, cacheMisses);
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	bool runSafetyCheck = argc < 2 || strcmp(argv[1], "--rt-safety") == 0;
+	bool runBenchmark = argc < 2 || strcmp(argv[1], "--benchmark") == 0;
+
+	bool realTimeSafe = runSafetyCheck ? checkRealTimeSafety() : true;
+	if (runBenchmark)
+	{
+		runStorageBenchmark();
+		runTailBenchmark();
+		runProcessModeBenchmark();
+		runGUITimerBenchmark();
+	}
+
+	return realTimeSafe ? 0 : 1;
+}
@@ -50,6 +50,9 @@ END_FACTORY
 - not used in ASPiK
 */
 bool InitModule(){
+	// --- keep parsed GUI descriptions and decoded bitmaps between editor opens for the life of the module
+	VSTGUI::UIDescriptionCache::setKeepAlive(true);
+	VSTGUI::BitmapCache::setKeepAlive(true);
 	return true;
 }
 
@@ -63,6 +66,8 @@ bool InitModule(){
 - not used in ASPiK
 */
 bool DeinitModule(){
+	VSTGUI::UIDescriptionCache::setKeepAlive(false);
+	VSTGUI::BitmapCache::setKeepAlive(false);
 	return true;
 }
 
@@ -18,10 +18,23 @@ namespace Steinberg {
 namespace Vst {
 namespace ASPiK {
 
-// --- for versioning in serialization
-static uint64 VSTPluginVersion = 0;		///< VST versioning for serialization
+// --- for versioning in serialization; parameters added in a later version are tagged with PluginParameter::setStateVersion( )
+//     1: Engine and Cross-Feed
+static uint64 VSTPluginVersion = 1;		///< VST versioning for serialization
 static FUID* VST3PluginCID = nullptr;	///< the FUID
 
+/**
+\brief convert a VST3 ProcessModes value (ProcessSetup::processMode) into the ASPiK hostProcessMode for ResetInfo
+*/
+static hostProcessMode getHostProcessMode(int32 processMode)
+{
+	if (processMode == kOffline)
+		return kOfflineProcessMode;
+	else if (processMode == kPrefetch)
+		return kPrefetchProcessMode;
+	return kRealtimeProcessMode;
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //	VST3Plugin::VST3Plugin
 //
@@ -430,8 +443,8 @@ NOTES:
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 tresult PLUGIN_API VST3Plugin::canProcessSampleSize(int32 symbolicSampleSize)
 {
-	// --- we support 32 bit audio
-	if (symbolicSampleSize == kSample32)
+	// --- we support 32 bit audio and native 64 bit audio (the DSP is double internally)
+	if (symbolicSampleSize == kSample32 || symbolicSampleSize == kSample64)
 	{
 		return kResultTrue;
 	}
@@ -451,12 +464,13 @@ NOTES:
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 tresult PLUGIN_API VST3Plugin::setupProcessing(ProcessSetup& newSetup)
 {
-    // --- reset
+    // --- reset; processSetup is not updated until the base class call, so use the new setup
     if(pluginCore)
     {
         ResetInfo info;
-        info.sampleRate = processSetup.sampleRate;
-        info.bitDepth = processSetup.symbolicSampleSize;
+        info.sampleRate = newSetup.sampleRate;
+        info.bitDepth = newSetup.symbolicSampleSize;
+        info.processMode = getHostProcessMode(newSetup.processMode);
         pluginCore->reset(info);
     }
 
@@ -514,6 +528,7 @@ tresult PLUGIN_API VST3Plugin::setActive(TBool state)
             ResetInfo info;
             info.sampleRate = processSetup.sampleRate;
             info.bitDepth = processSetup.symbolicSampleSize;
+            info.processMode = getHostProcessMode(processSetup.processMode);
             pluginCore->reset(info);
         }
 	}
@@ -548,27 +563,29 @@ tresult PLUGIN_API VST3Plugin::setState(IBStream* fileStream)
 	// --- read the version
 	if(!s.readInt64u(version)) return kResultFalse;
 
-    // --- serialize
+    // --- serialize; the batch keeps the audio thread on the previous state until all values are in
+	ScopedParameterBatch batch(pluginCore);
 	for (unsigned int i = 0; i < pluginCore->getPluginParameterCount(); i++)
     {
         PluginParameter* piParam = pluginCore->getPluginParameterByIndex(i);
 
         if(piParam)
         {
-            if(!s.readDouble(data))
+            // --- parameters newer than the saved state are not in the stream: back to their defaults
+            if(piParam->getStateVersion() > version)
+                data = piParam->getDefaultValue();
+            else if(!s.readDouble(data))
                 return kResultFalse;
-            else
-            {
-                // --- temp disable smoothing
-                bool smooth = piParam->getParameterSmoothing();
-                piParam->setParameterSmoothing(false);
 
-                // --- init actual, no smooth
-                piParam->setControlValue(data);
+            // --- temp disable smoothing
+            bool smooth = piParam->getParameterSmoothing();
+            piParam->setParameterSmoothing(false);
 
-                // --- reset
-                piParam->setParameterSmoothing(smooth);
-            }
+            // --- init actual, no smooth
+            piParam->setControlValue(data);
+
+            // --- reset
+            piParam->setParameterSmoothing(smooth);
         }
     }
 
@@ -690,11 +707,12 @@ bool VST3Plugin::doControlUpdate(ProcessData& data)
 
                 if(piParam)
                 {
-                    // --- add the sample accurate queue
-                    if (enableSAAVST3)
+                    // --- add the sample accurate queue (one per parameter; the core detaches it after the buffer)
+                    int32_t paramIndex = pluginCore->getPluginParameterIndexByControlID(pid);
+                    if (enableSAAVST3 && paramIndex >= 0 && m_pParamUpdateQueueArray[paramIndex])
                     {
-                        m_pParamUpdateQueueArray[i]->setParamValueQueue(queue, data.numSamples);
-                        piParam->setParameterUpdateQueue(m_pParamUpdateQueueArray[i]);
+                        m_pParamUpdateQueueArray[paramIndex]->setParamValueQueue(queue, data.numSamples);
+                        piParam->setParameterUpdateQueue(m_pParamUpdateQueueArray[paramIndex]);
                     }
                     else
                         piParam->setControlValueNormalized(value, true); // false = do not apply taper
@@ -774,8 +792,18 @@ tresult PLUGIN_API VST3Plugin::process(ProcessData& data)
     // --- setup buffer processing
     ProcessBufferInfo info;
 
-    info.inputs = isSynth ? nullptr : &data.inputs[0].channelBuffers32[0];
-    info.outputs = &data.outputs[0].channelBuffers32[0];
+    // --- 64 bit hosts get their double buffers passed straight through, no conversion
+    bool is64Bit = data.symbolicSampleSize == kSample64;
+    if (is64Bit)
+    {
+        info.inputs64 = isSynth ? nullptr : &data.inputs[0].channelBuffers64[0];
+        info.outputs64 = &data.outputs[0].channelBuffers64[0];
+    }
+    else
+    {
+        info.inputs = isSynth ? nullptr : &data.inputs[0].channelBuffers32[0];
+        info.outputs = &data.outputs[0].channelBuffers32[0];
+    }
 
     // --- setup channel formats
     SpeakerArrangement inputArr;
@@ -797,18 +825,29 @@ tresult PLUGIN_API VST3Plugin::process(ProcessData& data)
     // --- output (always)
     info.channelIOConfig.outputChannelFormat = getChannelFormatForSpkrArrangement(outputArr);
 
+    // --- VST3 silence flags from the host
+    if (!isSynth && data.numInputs > 0)
+        info.inputSilenceFlags = data.inputs[0].silenceFlags;
+
     // --- soft bypass for FX plugins
     if (plugInSideBypass && !isSynth)
     {
+        unsigned int numBypassChannels = info.numAudioInChannels < info.numAudioOutChannels ? info.numAudioInChannels : info.numAudioOutChannels;
         for (int32 sample = 0; sample < data.numSamples; sample++)
         {
             // --- output = input
-			for (unsigned int i = 0; i<info.numAuxAudioOutChannels; i++)
+			for (unsigned int i = 0; i<numBypassChannels; i++)
             {
-                (data.outputs[0].channelBuffers32[i])[sample] = (data.inputs[0].channelBuffers32[i])[sample];
+                if (is64Bit)
+                    (data.outputs[0].channelBuffers64[i])[sample] = (data.inputs[0].channelBuffers64[i])[sample];
+                else
+                    (data.outputs[0].channelBuffers32[i])[sample] = (data.inputs[0].channelBuffers32[i])[sample];
             }
         }
 
+        // --- output is as silent as the input
+        data.outputs[0].silenceFlags = info.inputSilenceFlags;
+
         // --- update the meters, force OFF
         updateMeters(data, true);
 
@@ -823,7 +862,10 @@ tresult PLUGIN_API VST3Plugin::process(ProcessData& data)
         if (bus && bus->isActive())
         {
             info.numAuxAudioInChannels = data.inputs[1].numChannels;
-            info.auxInputs = &data.inputs[1].channelBuffers32[0]; //** to sidechain
+            if (is64Bit)
+                info.auxInputs64 = &data.inputs[1].channelBuffers64[0]; //** to sidechain
+            else
+                info.auxInputs = &data.inputs[1].channelBuffers32[0]; //** to sidechain
         }
     }
 
@@ -849,6 +891,9 @@ tresult PLUGIN_API VST3Plugin::process(ProcessData& data)
     // --- process the buffers
     pluginCore->processAudioBuffers(info);
 
+    // --- let the host (and downstream plugins) skip our output while the tail is asleep
+    data.outputs[0].silenceFlags = info.outputSilenceFlags;
+
     // --- update the meters
     updateMeters(data);
 
@@ -1036,17 +1081,21 @@ tresult PLUGIN_API VST3Plugin::setComponentState(IBStream* fileStream)
     // --- read the version
     if(!s.readInt64u(version)) return kResultFalse;
 
-    // --- serialize
+    // --- serialize; the batch keeps the audio thread on the previous state until all values are in
+	ScopedParameterBatch batch(pluginCore);
 	for (unsigned int i = 0; i < pluginCore->getPluginParameterCount(); i++)
     {
         PluginParameter* piParam = pluginCore->getPluginParameterByIndex(i);
 
         if(piParam)
         {
-            if(!s.readDouble(data))
+            // --- parameters newer than the saved state are not in the stream: back to their defaults
+            if(piParam->getStateVersion() > version)
+                data = piParam->getDefaultValue();
+            else if(!s.readDouble(data))
                 return kResultFalse;
-            else
-                setParamNormalizedFromFile(piParam->getControlID(), data);
+
+            setParamNormalizedFromFile(piParam->getControlID(), data);
         }
     }
 
@@ -1112,6 +1161,9 @@ tresult PLUGIN_API VST3Plugin::setParamNormalized(ParamID tag, ParamValue value)
         PresetInfo* preset = pluginCore->getPreset(program);
         if(preset)
         {
+			// --- apply the whole preset atomically as far as the audio thread is concerned
+			ScopedParameterBatch batch(pluginCore);
+
 			for (unsigned int j = 0; j<preset->presetParameters.size(); j++)
             {
                 PresetParameter preParam = preset->presetParameters[j];
@@ -1138,6 +1190,10 @@ tresult PLUGIN_API VST3Plugin::setParamNormalized(ParamID tag, ParamValue value)
     {
         ParamValue actualValue = normalizedParamToPlain(tag, value);
         pluginCore->setPIParamValue(tag, actualValue);
+
+        // --- the GUI reads this (controller) copy; flag it now that it is current, since meter
+        //     values arrive here after the audio thread has already flagged them
+        pluginCore->markGUIParameterChanged(tag);
     }
 
  	return res;
@@ -1767,6 +1823,45 @@ bool VSTParamUpdateQueue::getNextValue(double& _nextValue)
 	return false;
 }
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//	VSTParamUpdateQueue::getPointCount
+//
+/**
+\brief ASPiK support for sample accurate auatomation: number of automation points in this buffer, for the
+       sub-block scheduler in PluginBase::processAudioBuffers( )
+*/
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+uint32_t VSTParamUpdateQueue::getPointCount()
+{
+	if (!parameterQueue)
+		return 0;
+
+	int32 count = parameterQueue->getPointCount();
+	return count > 0 ? (uint32_t)count : 0;
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+//	VSTParamUpdateQueue::getPoint
+//
+/**
+\brief ASPiK support for sample accurate auatomation: one automation point (sample offset, normalized value)
+*/
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool VSTParamUpdateQueue::getPoint(uint32_t index, uint32_t& _sampleOffset, double& normalizedValue)
+{
+	if (!parameterQueue)
+		return false;
+
+	int32 offset = 0;
+	ParamValue value = 0.0;
+	if (parameterQueue->getPoint((int32)index, offset, value) != Steinberg::kResultTrue)
+		return false;
+
+	_sampleOffset = offset > 0 ? (uint32_t)offset : 0;
+	normalizedValue = value;
+	return true;
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //	PluginEditor::PluginEditor
 //
@@ -1888,7 +1983,7 @@ tresult PLUGIN_API PluginEditor::attached(void* parent, FIDString type)
                         if(param)
                         {
                             // --- we have a parameter and control receiver pair!
-                            VST3UpdateHandler* vst3Updater = new VST3UpdateHandler(receiver, editController);
+                            VST3UpdateHandler* vst3Updater = new VST3UpdateHandler(receiver, pluginCore);
                             updateHandlers.insert(std::make_pair(info.id, vst3Updater));
                             param->addRef();
                             param->addDependent(vst3Updater);
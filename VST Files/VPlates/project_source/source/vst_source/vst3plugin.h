@@ -317,6 +317,8 @@ public:
 	unsigned int getParameterIndex();
 	bool getValueAtOffset(long int _sampleOffset, double _previousValue, double& _nextValue);
 	bool getNextValue(double& _nextValue);
+	uint32_t getPointCount();
+	bool getPoint(uint32_t index, uint32_t& _sampleOffset, double& normalizedValue);
 };
 
 
@@ -419,6 +421,13 @@ public:
 			customViewIF->pushDataValue(data);
 	}
 
+	/** forward call to ICustomView interface *if it is still alive* */
+	virtual void pushDataBlock(const float* data, uint32_t numValues)
+	{
+		if (customViewIF)
+			customViewIF->pushDataBlock(data, numValues);
+	}
+
 	/** forward call to ICustomView interface *if it is still alive* */
 	virtual void sendMessage(void* data)
 	{
@@ -498,6 +507,13 @@ public:
         editController->performEdit(controlID, normalizedValue);
     }
 
+	/** GUI timer: control IDs whose values changed since the last ping (lock-free flags in the core) */
+	virtual bool getGUIParameterChanges(std::vector<int32_t>& changedControlIDs)
+	{
+		if (!pluginCore) return false;
+		return pluginCore->getGUIParameterChanges(changedControlIDs);
+	}
+
 	/** get VST parameter in normalized form */
     virtual double getNormalizedPluginParameter(int32_t controlID)
     {
@@ -729,6 +745,20 @@ public:
         return 0;
     }
 
+    /** sample offset of the next event that has not been fired */
+    virtual bool getNextEventOffset(unsigned int& sampleOffset)
+    {
+        Event e = { 0 };
+        if (!inputEvents || inputEvents->getEvent(currentEventIndex, e) != kResultTrue)
+            return false;
+
+        sampleOffset = (unsigned int)e.sampleOffset;
+        return true;
+    }
+
+    /** VST3 event lists are sorted by offset, so the core can schedule them */
+    virtual bool canScheduleEvents() { return true; }
+
     /** send MIDI event at this sample offset to core */
     virtual bool fireMidiEvents(unsigned int sampleOffset)
     {
@@ -812,18 +842,9 @@ public:
                     }
                 } // switch
 
-                // --- have next event?
-                if (inputEvents->getEvent(currentEventIndex + 1, e) == kResultTrue)
-                {
-                    if (e.sampleOffset == sampleOffset)
-                    {
-                        // --- avance current index
-                        currentEventIndex++;
-                    }
-                    else
-                        haveEvents = false;
-                }
-                else
+                // --- this one is done; have next event at the same offset?
+                currentEventIndex++;
+                if (inputEvents->getEvent(currentEventIndex, e) != kResultTrue || e.sampleOffset != sampleOffset)
                     haveEvents = false;
             }
         }
@@ -843,6 +864,10 @@ protected:
 \brief
 Little update handler object for VST-approved GUI updating
 
+Operation:
+- a parameter change only flags the parameter in the core; PluginGUI::idle( ) applies the flagged parameters to
+  their controls once per timer ping, however many times they changed in between
+
 \author Will Pirkle http://www.willpirkle.com
 \remark This object is included in Designing Audio Effects Plugins in C++ 2nd Ed. by Will Pirkle
 \version Revision : 1.0
@@ -851,21 +876,18 @@ Little update handler object for VST-approved GUI updating
 class VST3UpdateHandler: public FObject
 {
 public:
-    VST3UpdateHandler(VSTGUI::ControlUpdateReceiver* _receiver, VST3Plugin* _editController){ receiver = _receiver; editController = _editController; }
+    VST3UpdateHandler(VSTGUI::ControlUpdateReceiver* _receiver, PluginCore* _pluginCore){ receiver = _receiver; pluginCore = _pluginCore; }
     ~VST3UpdateHandler(){}
 
     virtual void PLUGIN_API update (FUnknown* changedUnknown, int32 message)
     {
-        if(message == IDependent::kChanged && receiver && editController)
-        {
-            double normalizedValue = editController->getParamNormalized (receiver->getControlID());
-            receiver->updateControlsWithNormalizedValue(normalizedValue);
-        }
+        if(message == IDependent::kChanged && receiver && pluginCore)
+            pluginCore->markGUIParameterChanged(receiver->getControlID());
     }
 
 private:
     VSTGUI::ControlUpdateReceiver* receiver = nullptr;
-    VST3Plugin* editController = nullptr;
+    PluginCore* pluginCore = nullptr;
 
 };
 